@@ -26,7 +26,9 @@
 typedef enum parserStatus_e {
     USTREAM_PROCESSING,
     USTREAM_FINISHED,
-    USTREAM_FAULT
+    USTREAM_FAULT,
+    // Stopped after a clause, the end of the data is left to the next call
+    USTREAM_SUSPENDED
 } parserStatus_e;
 
 typedef struct txInt256_t {
@@ -0,0 +1,341 @@
+/*******************************************************************************
+*   Ledger Blue
+*   (c) 2016 Ledger
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#include <string.h>
+#include "vetCertificateUstream.h"
+#include "vetTrace.h"
+
+typedef enum certKind_e {
+    CERT_KIND_STRING,
+    CERT_KIND_NUMBER,
+    CERT_KIND_OBJECT
+} certKind_e;
+
+// Handling of a value longer than the characters kept for the review
+typedef enum certCut_e {
+    CERT_CUT_NONE,  // rejected
+    CERT_CUT_END,   // its start is kept, followed by "..."
+    CERT_CUT_START  // its end is kept, after "..."
+} certCut_e;
+
+typedef struct certFieldDefinition_t {
+    uint8_t depth;
+    char key[CERT_KEY_LENGTH + 1];
+    uint8_t kind;
+    // Characters kept for the review
+    uint8_t capacity;
+    // One of certCut_e
+    uint8_t cut;
+} certFieldDefinition_t;
+
+static const certFieldDefinition_t CERT_FIELDS[] = {
+    [CERT_FIELD_NONE] = {0, "", CERT_KIND_OBJECT, 0, CERT_CUT_NONE},
+    // The end of a domain identifies it
+    [CERT_FIELD_DOMAIN] = {1, "domain", CERT_KIND_STRING, CERT_DOMAIN_LENGTH, CERT_CUT_START},
+    [CERT_FIELD_PAYLOAD] = {1, "payload", CERT_KIND_OBJECT, 0, CERT_CUT_NONE},
+    [CERT_FIELD_PAYLOAD_CONTENT] = {2, "content", CERT_KIND_STRING, CERT_CONTENT_LENGTH, CERT_CUT_END},
+    [CERT_FIELD_PAYLOAD_TYPE] = {2, "type", CERT_KIND_STRING, CERT_TYPE_LENGTH, CERT_CUT_NONE},
+    [CERT_FIELD_PURPOSE] = {1, "purpose", CERT_KIND_STRING, CERT_PURPOSE_LENGTH, CERT_CUT_NONE},
+    [CERT_FIELD_SIGNER] = {1, "signer", CERT_KIND_STRING, CERT_SIGNER_LENGTH, CERT_CUT_NONE},
+    [CERT_FIELD_TIMESTAMP] = {1, "timestamp", CERT_KIND_NUMBER, CERT_TIMESTAMP_LENGTH, CERT_CUT_NONE},
+};
+
+#define CERT_FIELDS_COUNT (sizeof(CERT_FIELDS) / sizeof(CERT_FIELDS[0]))
+
+void initCertificate(certificateContext_t *context, certificateContent_t *content) {
+    memset(context, 0, sizeof(certificateContext_t));
+    memset(content, 0, sizeof(certificateContent_t));
+    context->content = content;
+    context->state = CERT_STATE_START;
+}
+
+static char *certFieldBuffer(certificateContent_t *content, certField_e field) {
+    switch (field) {
+    case CERT_FIELD_DOMAIN:
+        return content->domain;
+    case CERT_FIELD_PAYLOAD_CONTENT:
+        return content->payloadContent;
+    case CERT_FIELD_PAYLOAD_TYPE:
+        return content->payloadType;
+    case CERT_FIELD_PURPOSE:
+        return content->purpose;
+    case CERT_FIELD_SIGNER:
+        return content->signer;
+    case CERT_FIELD_TIMESTAMP:
+        return content->timestamp;
+    default:
+        return NULL;
+    }
+}
+
+// Adds a character to the value being parsed, false if the value is too long
+static bool certAppend(certificateContext_t *context, char c) {
+    const certFieldDefinition_t *definition = PIC(&CERT_FIELDS[context->field]);
+    char *buffer = certFieldBuffer(context->content, context->field);
+
+    if (context->valueLength < definition->capacity) {
+        buffer[context->valueLength] = c;
+        buffer[context->valueLength + 1] = '\0';
+    } else if (definition->cut == CERT_CUT_NONE) {
+        return false;
+    } else if (definition->cut == CERT_CUT_END) {
+        if (context->valueLength == definition->capacity) {
+            memmove(buffer + definition->capacity, "...", 4);
+        }
+    } else {
+        if (context->valueLength == definition->capacity) {
+            memmove(buffer + 3, buffer, definition->capacity + 1);
+            memmove(buffer, "...", 3);
+        }
+        // Drop the first character kept, the terminator following the last one
+        memmove(buffer + 3, buffer + 4, definition->capacity);
+        buffer[definition->capacity + 2] = c;
+    }
+    if (context->valueLength <= definition->capacity) {
+        // Not counted any more once the value is cut
+        context->valueLength++;
+    }
+    return true;
+}
+
+// Looks for the field of the key just parsed, which must follow the previous key of its object
+static bool certKeyDone(certificateContext_t *context) {
+    char *previousKey = context->previousKey[context->depth - 1];
+    uint8_t i;
+
+    context->key[context->keyLength] = '\0';
+    if (strcmp(context->key, previousKey) <= 0) {
+        // Unsorted or repeated key
+        return false;
+    }
+    memmove(previousKey, context->key, context->keyLength + 1);
+    for (i = 1; i < CERT_FIELDS_COUNT; i++) {
+        const certFieldDefinition_t *definition = PIC(&CERT_FIELDS[i]);
+        if ((definition->depth == context->depth) && (strcmp(definition->key, context->key) == 0)) {
+            context->field = (certField_e) i;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Checks a string value once parsed
+static bool certStringDone(certificateContext_t *context) {
+    uint8_t i;
+
+    if (context->field != CERT_FIELD_SIGNER) {
+        return true;
+    }
+    // Lowercase hex address
+    if ((context->valueLength != CERT_SIGNER_LENGTH) || (context->content->signer[0] != '0') ||
+        (context->content->signer[1] != 'x')) {
+        return false;
+    }
+    for (i = 2; i < CERT_SIGNER_LENGTH; i++) {
+        char c = context->content->signer[i];
+        if (!(((c >= '0') && (c <= '9')) || ((c >= 'a') && (c <= 'f')))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Closes the certificate or its payload
+static bool certObjectDone(certificateContext_t *context) {
+    context->depth--;
+    if (context->depth != 0) {
+        context->field = CERT_FIELD_PAYLOAD;
+        context->state = CERT_STATE_COMMA_OR_END;
+        return true;
+    }
+    context->state = CERT_STATE_DONE;
+    return (context->content->fields & CERT_FIELDS_REQUIRED) == CERT_FIELDS_REQUIRED;
+}
+
+static bool certValueStart(certificateContext_t *context, uint8_t c) {
+    const certFieldDefinition_t *definition = PIC(&CERT_FIELDS[context->field]);
+
+    context->content->fields |= CERT_FIELD_BIT(context->field);
+    context->valueLength = 0;
+    if ((c == '"') && (definition->kind == CERT_KIND_STRING)) {
+        context->state = CERT_STATE_STRING;
+        return true;
+    }
+    if ((c == '{') && (definition->kind == CERT_KIND_OBJECT)) {
+        context->depth++;
+        context->previousKey[context->depth - 1][0] = '\0';
+        context->state = CERT_STATE_KEY_OR_END;
+        return true;
+    }
+    if ((c >= '0') && (c <= '9') && (definition->kind == CERT_KIND_NUMBER)) {
+        context->state = CERT_STATE_NUMBER;
+        return certAppend(context, c);
+    }
+    return false;
+}
+
+static bool certEscape(certificateContext_t *context, uint8_t c) {
+    context->state = CERT_STATE_STRING;
+    switch (c) {
+    case '"':
+    case '\\':
+        return certAppend(context, c);
+    case 'b':
+    case 'f':
+    case 'n':
+    case 'r':
+    case 't':
+        return certAppend(context, ' ');
+    case 'u':
+        context->unicode = 0;
+        context->unicodeDigits = 0;
+        context->state = CERT_STATE_UNICODE;
+        return true;
+    default:
+        // Including "\/", never produced by a canonical encoding
+        return false;
+    }
+}
+
+static bool certUnicode(certificateContext_t *context, uint8_t c) {
+    uint8_t digit;
+
+    if ((c >= '0') && (c <= '9')) {
+        digit = c - '0';
+    } else if ((c >= 'a') && (c <= 'f')) {
+        digit = c - 'a' + 10;
+    } else {
+        return false;
+    }
+    context->unicode = (context->unicode << 4) | digit;
+    if (++context->unicodeDigits < 4) {
+        return true;
+    }
+    context->state = CERT_STATE_STRING;
+    // Only control characters and lone surrogates are escaped by a canonical encoding
+    if (context->unicode < 0x20) {
+        return certAppend(context, ' ');
+    }
+    if ((context->unicode >= 0xD800) && (context->unicode <= 0xDFFF)) {
+        return certAppend(context, '?');
+    }
+    return false;
+}
+
+static bool certString(certificateContext_t *context, uint8_t c) {
+    if (c == '"') {
+        context->state = CERT_STATE_COMMA_OR_END;
+        return certStringDone(context);
+    }
+    if (c == '\\') {
+        context->state = CERT_STATE_ESCAPE;
+        return true;
+    }
+    if (c < 0x20) {
+        return false;
+    }
+    if (c < 0x80) {
+        return certAppend(context, c);
+    }
+    if ((c < 0xC0) && (context->field != CERT_FIELD_SIGNER)) {
+        // Continuation of a character already displayed
+        return true;
+    }
+    if ((c >= 0xC2) && (c <= 0xF4)) {
+        // Not displayed by all devices
+        return certAppend(context, '?');
+    }
+    return false;
+}
+
+static bool certByte(certificateContext_t *context, uint8_t c) {
+    switch (context->state) {
+    case CERT_STATE_START:
+        if (c != '{') {
+            return false;
+        }
+        context->depth = 1;
+        context->state = CERT_STATE_KEY_OR_END;
+        return true;
+    case CERT_STATE_KEY_OR_END:
+        if (c == '}') {
+            return certObjectDone(context);
+        }
+        // Fall through
+    case CERT_STATE_KEY:
+        if (c != '"') {
+            return false;
+        }
+        context->keyLength = 0;
+        context->state = CERT_STATE_KEY_STRING;
+        return true;
+    case CERT_STATE_KEY_STRING:
+        if (c == '"') {
+            context->state = CERT_STATE_COLON;
+            return certKeyDone(context);
+        }
+        if ((c < 'a') || (c > 'z') || (context->keyLength == CERT_KEY_LENGTH)) {
+            return false;
+        }
+        context->key[context->keyLength++] = c;
+        return true;
+    case CERT_STATE_COLON:
+        context->state = CERT_STATE_VALUE;
+        return c == ':';
+    case CERT_STATE_VALUE:
+        return certValueStart(context, c);
+    case CERT_STATE_STRING:
+        return certString(context, c);
+    case CERT_STATE_ESCAPE:
+        return certEscape(context, c);
+    case CERT_STATE_UNICODE:
+        return certUnicode(context, c);
+    case CERT_STATE_NUMBER:
+        if ((c >= '0') && (c <= '9')) {
+            // No leading zero
+            return (context->content->timestamp[0] != '0') && certAppend(context, c);
+        }
+        context->state = CERT_STATE_COMMA_OR_END;
+        return certByte(context, c);
+    case CERT_STATE_COMMA_OR_END:
+        if (c == ',') {
+            context->state = CERT_STATE_KEY;
+            return true;
+        }
+        return (c == '}') && certObjectDone(context);
+    default:
+        // Nothing may follow the certificate
+        return false;
+    }
+}
+
+parserStatus_e processCertificate(certificateContext_t *context, const uint8_t *buffer, uint32_t length) {
+    uint32_t i;
+
+    if (context->content == NULL) {
+        PRINTF("Certificate parser not initialized\n");
+        return USTREAM_FAULT;
+    }
+    for (i = 0; i < length; i++) {
+        if (!certByte(context, buffer[i])) {
+            TRACE(TRACE_PARSE_ERROR, context->state, TRACE_ERROR_DECODE);
+            context->content = NULL;
+            return USTREAM_FAULT;
+        }
+    }
+    return (context->state == CERT_STATE_DONE) ? USTREAM_FINISHED : USTREAM_PROCESSING;
+}
@@ -0,0 +1,105 @@
+/*******************************************************************************
+*   Ledger Blue
+*   (c) 2016 Ledger
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#ifndef _VET_CERTIFICATE_USTREAM_H_
+#define _VET_CERTIFICATE_USTREAM_H_
+
+#include "os.h"
+#include <stdbool.h>
+#include "ustream.h"
+
+/* Characters of the certificate fields kept for the review. A longer payload content is cut
+   and ends with "...", a longer domain keeps its end after "...", the end of a domain being what
+   identifies it. A longer value of the other fields is rejected. */
+#define CERT_PURPOSE_LENGTH 16
+#define CERT_TYPE_LENGTH 16
+#define CERT_CONTENT_LENGTH 64
+#define CERT_DOMAIN_LENGTH 48
+#define CERT_TIMESTAMP_LENGTH 20
+#define CERT_SIGNER_LENGTH 42
+// Longest key of a certificate, "timestamp"
+#define CERT_KEY_LENGTH 9
+
+/* Fields of a certificate, in the order of their keys at each level */
+typedef enum certField_e {
+    CERT_FIELD_NONE = 0,
+    CERT_FIELD_DOMAIN,
+    CERT_FIELD_PAYLOAD,
+    CERT_FIELD_PAYLOAD_CONTENT,
+    CERT_FIELD_PAYLOAD_TYPE,
+    CERT_FIELD_PURPOSE,
+    CERT_FIELD_SIGNER,
+    CERT_FIELD_TIMESTAMP
+} certField_e;
+
+#define CERT_FIELD_BIT(field) (1 << (field))
+// Fields a certificate must have, the signer being optional
+#define CERT_FIELDS_REQUIRED                                                                  \
+    (CERT_FIELD_BIT(CERT_FIELD_DOMAIN) | CERT_FIELD_BIT(CERT_FIELD_PAYLOAD) |                 \
+     CERT_FIELD_BIT(CERT_FIELD_PAYLOAD_CONTENT) | CERT_FIELD_BIT(CERT_FIELD_PAYLOAD_TYPE) |   \
+     CERT_FIELD_BIT(CERT_FIELD_PURPOSE) | CERT_FIELD_BIT(CERT_FIELD_TIMESTAMP))
+
+/* Fields of a certificate kept for its review, NUL terminated */
+typedef struct certificateContent_t {
+    char purpose[CERT_PURPOSE_LENGTH + 1];
+    char payloadType[CERT_TYPE_LENGTH + 1];
+    char payloadContent[CERT_CONTENT_LENGTH + 4];
+    char domain[CERT_DOMAIN_LENGTH + 4];
+    char timestamp[CERT_TIMESTAMP_LENGTH + 1];
+    char signer[CERT_SIGNER_LENGTH + 1];
+    // One CERT_FIELD_BIT per field found
+    uint8_t fields;
+} certificateContent_t;
+
+typedef enum certState_e {
+    CERT_STATE_START = 0,   // before the certificate
+    CERT_STATE_KEY_OR_END,  // after an opening brace
+    CERT_STATE_KEY,         // after a comma
+    CERT_STATE_KEY_STRING,  // in a key
+    CERT_STATE_COLON,       // after a key
+    CERT_STATE_VALUE,       // after a colon
+    CERT_STATE_STRING,      // in a string value
+    CERT_STATE_ESCAPE,      // after a backslash in a string value
+    CERT_STATE_UNICODE,     // in the hex digits of a \u escape
+    CERT_STATE_NUMBER,      // in a number value
+    CERT_STATE_COMMA_OR_END,// after a value
+    CERT_STATE_DONE         // after the certificate
+} certState_e;
+
+/* State of the certificate tokenizer, kept between the data blocks. The certificate is the
+   canonical JSON of its fields: keys sorted, no whitespace, integer timestamp. */
+typedef struct certificateContext_t {
+    certState_e state;
+    // 1 in the certificate, 2 in its payload
+    uint8_t depth;
+    // Field of the key or value being parsed
+    certField_e field;
+    // Characters of the value being parsed, kept or not
+    uint16_t valueLength;
+    uint16_t unicode;
+    uint8_t unicodeDigits;
+    uint8_t keyLength;
+    char key[CERT_KEY_LENGTH + 1];
+    // Previous key of the certificate and of its payload, the keys being sorted
+    char previousKey[2][CERT_KEY_LENGTH + 1];
+    certificateContent_t *content;
+} certificateContext_t;
+
+void initCertificate(certificateContext_t *context, certificateContent_t *content);
+parserStatus_e processCertificate(certificateContext_t *context, const uint8_t *buffer, uint32_t length);
+
+#endif
@@ -15,6 +15,7 @@
 
 #include "vetClauseUstream.h"
 #include "vetUtils.h"
+#include "vetTrace.h"
 
 #define MAX_INT256 32
 #define MAX_INT64 8
@@ -26,6 +27,10 @@
 void initClause(clauseContext_t *context, clauseContent_t *content) {
     memset(context, 0, sizeof(clauseContext_t));
     context->content = content;
+    if (content != NULL) {
+        // The buffer of the clauses following the first one is reused
+        memset(content, 0, sizeof(clauseContent_t));
+    }
     context->currentField = CLAUSE_RLP_TO;
 }
 
@@ -75,11 +80,13 @@ static void processToField(clauseContext_t *context) {
                  ? context->commandLength
                  : context->currentFieldLength - context->currentFieldPos);
         copyClauseData(context,
-                       context->content->to + context->currentFieldPos,
-                      copySize);
+                       (context->content != NULL ? context->content->to + context->currentFieldPos : NULL),
+                       copySize);
     }
     if (context->currentFieldPos == context->currentFieldLength) {
-        context->content->toLength = context->currentFieldLength;
+        if (context->content != NULL) {
+            context->content->toLength = context->currentFieldLength;
+        }
         context->currentField++;
         context->processingField = false;
     }
@@ -101,11 +108,13 @@ static void processValueField(clauseContext_t *context) {
                  ? context->commandLength
                  : context->currentFieldLength - context->currentFieldPos);
         copyClauseData(context,
-                       context->content->value.value + context->currentFieldPos,
+                       (context->content != NULL ? context->content->value.value + context->currentFieldPos : NULL),
                        copySize);
     }
     if (context->currentFieldPos == context->currentFieldLength) {
-        context->content->value.length = context->currentFieldLength;
+        if (context->content != NULL) {
+            context->content->value.length = context->currentFieldLength;
+        }
         context->currentField++;
         context->processingField = false;
     }
@@ -116,25 +125,42 @@ static void processDataField(clauseContext_t *context) {
         PRINTF("Invalid type for CLAUSE_RLP_DATA\n");
         THROW(EXCEPTION);
     }
-    context->content->dataPresent = (context->currentFieldLength != 0);
-    if (context->currentFieldLength == sizeof(context->content->data)) {
-        if (context->currentFieldPos < context->currentFieldLength) {
-            uint32_t copySize = (context->commandLength <
-                                            ((context->currentFieldLength -
-                                            context->currentFieldPos))
-                                        ? context->commandLength
-                                        : context->currentFieldLength -
-                                            context->currentFieldPos);
-            copyClauseData(context,
-                           context->content->data + context->currentFieldPos,
-                           copySize);
+    context->dataPresent = (context->currentFieldLength != 0);
+    if (context->content == NULL) {
+        // Fields not kept, the data is skipped by the caller
+        context->currentField++;
+        context->processingField = false;
+        return;
+    }
+    if (context->currentFieldPos == 0) {
+        context->content->dataPresent = context->dataPresent;
+        context->content->data.length = context->currentFieldLength;
+        if (context->dataPresent) {
+            CX_ASSERT(cx_blake2b_init_no_throw(&context->dataHash, 256));
+        }
+    }
+    if (context->currentFieldPos < context->currentFieldLength) {
+        uint32_t copySize = (context->commandLength <
+                                        ((context->currentFieldLength -
+                                        context->currentFieldPos))
+                                    ? context->commandLength
+                                    : context->currentFieldLength -
+                                        context->currentFieldPos);
+        // Only the leading bytes are kept, all of them are hashed
+        if (context->currentFieldPos < CLAUSE_DATA_WINDOW) {
+            memmove(context->content->data.window + context->currentFieldPos, context->workBuffer,
+                    (copySize < CLAUSE_DATA_WINDOW - context->currentFieldPos
+                         ? copySize
+                         : CLAUSE_DATA_WINDOW - context->currentFieldPos));
         }
-        if (context->currentFieldPos == context->currentFieldLength) {
-            context->currentField++;
-            context->processingField = false;
+        CX_ASSERT(cx_hash_no_throw((cx_hash_t *)&context->dataHash, 0, context->workBuffer, copySize, NULL, 0));
+        copyClauseData(context, NULL, copySize);
+    }
+    if (context->currentFieldPos == context->currentFieldLength) {
+        if (context->dataPresent) {
+            CX_ASSERT(cx_hash_no_throw((cx_hash_t *)&context->dataHash, CX_LAST, NULL, 0,
+                                       context->content->data.hash, sizeof(context->content->data.hash)));
         }
-    } else {
-        // If not token transaction, return immediately without reading
         context->currentField++;
         context->processingField = false;
     }
@@ -161,7 +187,7 @@ static parserStatus_e processClauseInternal(clauseContext_t *context) {
                                  &valid)) {
                     // Can decode now, if valid
                     if (!valid) {
-                        PRINTF("RLP pre-decode error\n");
+                        TRACE(TRACE_PARSE_ERROR, context->currentField, TRACE_ERROR_PRE_DECODE);
                         return USTREAM_FAULT;
                     }
                     canDecode = true;
@@ -170,7 +196,7 @@ static parserStatus_e processClauseInternal(clauseContext_t *context) {
                 // Cannot decode yet
                 // Sanity check
                 if (context->rlpBufferPos == sizeof(context->rlpBuffer)) {
-                    PRINTF("RLP pre-decode logic error\n");
+                    TRACE(TRACE_PARSE_ERROR, context->currentField, TRACE_ERROR_PRE_DECODE_LOGIC);
                     return USTREAM_FAULT;
                 }
             }
@@ -181,7 +207,7 @@ static parserStatus_e processClauseInternal(clauseContext_t *context) {
             if (!rlpDecodeLength(context->rlpBuffer, context->rlpBufferPos,
                                  &context->currentFieldLength, &offset,
                                  &context->currentFieldIsList)) {
-                PRINTF("RLP decode error\n");
+                TRACE(TRACE_PARSE_ERROR, context->currentField, TRACE_ERROR_DECODE);
                 return USTREAM_FAULT;
             }
             if (offset == 0) {
@@ -207,7 +233,7 @@ static parserStatus_e processClauseInternal(clauseContext_t *context) {
             processDataField(context);
             break;
         default:
-            PRINTF("Invalid RLP decoder context\n");
+            TRACE(TRACE_PARSE_ERROR, context->currentField, TRACE_ERROR_CONTEXT);
             return USTREAM_FAULT;
         }
     }
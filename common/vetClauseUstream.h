@@ -27,11 +27,25 @@ typedef enum rlpClauseField_e {
     CLAUSE_RLP_DONE
 } rlpClauseField_e;
 
+/* Data of a clause kept for its review: the selector and the first words, which also hold
+   a token transfer. The rest of the data is only hashed, whatever its length. */
+#define CLAUSE_DATA_WORDS 3
+#define CLAUSE_DATA_WINDOW (4 + CLAUSE_DATA_WORDS * 32)
+
+typedef struct clauseData_t {
+    // Leading bytes of the data, up to CLAUSE_DATA_WINDOW
+    uint8_t window[CLAUSE_DATA_WINDOW];
+    // Length of the whole data
+    uint32_t length;
+    // BLAKE2b-256 of the whole data, once the clause has been parsed
+    uint8_t hash[32];
+} clauseData_t;
+
 typedef struct clauseContent_t {
     uint8_t to[20];
     uint8_t toLength;
     txInt256_t value;
-    uint8_t data[4 + 32 + 32];
+    clauseData_t data;
     bool dataPresent;
 } clauseContent_t;
 
@@ -47,7 +61,11 @@ typedef struct clauseContext_t {
     uint32_t rlpBufferPos;
     uint8_t *workBuffer;
     uint32_t commandLength;
+    // NULL when the fields of the clause are not kept
     clauseContent_t *content;
+    bool dataPresent;
+    // Running hash of the data, when the fields are kept
+    cx_blake2b_t dataHash;
 } clauseContext_t;
 
 void initClause(clauseContext_t *context, clauseContent_t *content);
@@ -15,6 +15,7 @@
 
 #include "vetClausesUstream.h"
 #include "vetUtils.h"
+#include "vetTrace.h"
 
 #define MAX_INT256 32
 #define MAX_INT64 8
@@ -81,15 +82,26 @@ static void processClauseField(clausesContext_t *context, clauseContext_t *claus
                         copySize);
     }
     if (context->currentFieldPos == context->currentFieldLength) {
-        if (clauseContext->content->dataPresent) {
+        if (clauseContext->dataPresent) {
             context->content->dataPresent = true;
         }
         context->processingField = false;
+        if (context->clauseDone != NULL) {
+            ((clauseCallback_t)PIC(context->clauseDone))(context->content->clausesLength - 1,
+                                                         clauseContext->content,
+                                                         clauseContext->dataPresent);
+        }
+        if (context->suspendAfterClause) {
+            context->suspended = true;
+        }
     }
 }
 
 static parserStatus_e processClausesInternal(clausesContext_t *context, clauseContext_t *clauseContext) {
     for (;;) {
+        if (context->suspended) {
+            return USTREAM_SUSPENDED;
+        }
         if (context->commandLength == 0) {
             return USTREAM_FINISHED;
         }
@@ -105,7 +117,7 @@ static parserStatus_e processClausesInternal(clausesContext_t *context, clauseCo
                                  &valid)) {
                     // Can decode now, if valid
                     if (!valid) {
-                        PRINTF("RLP pre-decode error\n");
+                        TRACE(TRACE_PARSE_ERROR, context->currentField, TRACE_ERROR_PRE_DECODE);
                         return USTREAM_FAULT;
                     }
                     canDecode = true;
@@ -114,7 +126,7 @@ static parserStatus_e processClausesInternal(clausesContext_t *context, clauseCo
                 // Cannot decode yet
                 // Sanity check
                 if (context->rlpBufferPos == sizeof(context->rlpBuffer)) {
-                    PRINTF("RLP pre-decode logic error\n");
+                    TRACE(TRACE_PARSE_ERROR, context->currentField, TRACE_ERROR_PRE_DECODE_LOGIC);
                     return USTREAM_FAULT;
                 }
             }
@@ -125,7 +137,7 @@ static parserStatus_e processClausesInternal(clausesContext_t *context, clauseCo
             if (!rlpDecodeLength(context->rlpBuffer, context->rlpBufferPos,
                                  &context->currentFieldLength, &offset,
                                  &context->currentFieldIsList)) {
-                PRINTF("RLP decode error\n");
+                TRACE(TRACE_PARSE_ERROR, context->currentField, TRACE_ERROR_DECODE);
                 return USTREAM_FAULT;
             }
             if (offset == 0) {
@@ -136,15 +148,19 @@ static parserStatus_e processClausesInternal(clausesContext_t *context, clauseCo
             } else {
                 context->fieldSingleByte = false;
             }
+            // The count of clauses must not wrap back to the first clause
+            if (context->content->clausesLength == UINT16_MAX) {
+                TRACE(TRACE_PARSE_ERROR, context->currentField, TRACE_ERROR_CONTEXT);
+                return USTREAM_FAULT;
+            }
             context->currentFieldPos = 0;
             context->rlpBufferPos = 0;
             context->processingField = true;
-            if (context->content->clausesLength == 0) {
-                initClause(clauseContext, context->content->firstClause);
-            } else {
-                clauseContent_t tmpContent;
-                initClause(clauseContext, &tmpContent);
-            }
+            // The fields of the first clause are kept for the whole transaction,
+            // the ones of the following clauses until the next clause only
+            initClause(clauseContext,
+                       (context->content->clausesLength == 0 ? context->content->firstClause : context->nextClause));
+            TRACE(TRACE_CLAUSE, context->content->clausesLength, context->currentFieldLength);
             context->content->clausesLength++;
         }
         switch (context->currentField) {
@@ -152,7 +168,7 @@ static parserStatus_e processClausesInternal(clausesContext_t *context, clauseCo
             processClauseField(context, clauseContext);
             break;
         default:
-            PRINTF("Invalid RLP decoder context\n");
+            TRACE(TRACE_PARSE_ERROR, context->currentField, TRACE_ERROR_CONTEXT);
             return USTREAM_FAULT;
         }
     }
@@ -26,9 +26,12 @@ typedef enum rlpClausesField_e {
     CLAUSES_RLP_DONE
 } rlpClausesField_e;
 
+/* Called each time a clause has been parsed, with its fields when they are kept */
+typedef void (*clauseCallback_t)(uint16_t index, clauseContent_t *content, bool dataPresent);
+
 typedef struct clausesContent_t {
     clauseContent_t *firstClause;
-    uint8_t clausesLength;
+    uint16_t clausesLength;
     bool dataPresent;
 } clausesContent_t;
 
@@ -45,6 +48,13 @@ typedef struct clausesContext_t {
     uint8_t *workBuffer;
     uint32_t commandLength;
     clausesContent_t *content;
+    // Fields of the clauses following the first one, not kept when NULL
+    clauseContent_t *nextClause;
+    // Clause completion hook, none when NULL
+    clauseCallback_t clauseDone;
+    // When set, parsing stops after each clause until suspended is cleared
+    bool suspendAfterClause;
+    bool suspended;
 } clausesContext_t;
 
 void initClauses(clausesContext_t *context, clausesContent_t *content, clauseContext_t *clauseContext, clauseContent_t *clauseContent);
@@ -0,0 +1,84 @@
+/*******************************************************************************
+*   Ledger Blue
+*   (c) 2016 Ledger
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#include "vetProfile.h"
+
+#ifdef HAVE_VET_PROFILE
+
+#include <string.h>
+
+// Breakdown of the last request, the number of completed runs of each stage
+static uint32_t profile[PROFILE_STAGE_COUNT];
+
+/**
+ * @brief Clears the breakdown, called when a new request starts.
+ */
+void vet_profile_reset(void) {
+    memset(profile, 0, sizeof(profile));
+}
+
+/**
+ * @brief Marks the beginning of a stage.
+ *
+ * @details Never inlined nor removed: tests/benchmarks/insn_count.py breaks on the entry of this
+ * function and of vet_profile_end() to attribute the instructions executed in between to the stage.
+ *
+ * @param[in] stage Stage starting.
+ */
+__attribute__((noinline)) void vet_profile_begin(profileStage_e stage) {
+    UNUSED(stage);
+    __asm__ volatile("" ::: "memory");
+}
+
+/**
+ * @brief Marks the end of a stage and counts its run.
+ *
+ * @details A stage interrupted by an exception is simply not accounted.
+ *
+ * @param[in] stage Stage ending.
+ */
+__attribute__((noinline)) void vet_profile_end(profileStage_e stage) {
+    profile[stage]++;
+}
+
+/**
+ * @brief Serializes the breakdown of the last request.
+ *
+ * @details For each stage, in profileStage_e order: number of runs (4), big endian.
+ *
+ * @param[out] out Output buffer.
+ * @param[in] outLength Size of the output buffer.
+ *
+ * @return The size of the breakdown, 0 if it does not fit.
+ */
+uint32_t vet_profile_dump(uint8_t *out, uint32_t outLength) {
+    uint32_t tx = 0;
+    uint8_t i;
+
+    if (outLength < PROFILE_STAGE_COUNT * PROFILE_RECORD_LENGTH) {
+        return 0;
+    }
+    for (i = 0; i < PROFILE_STAGE_COUNT; i++) {
+        out[tx++] = profile[i] >> 24;
+        out[tx++] = profile[i] >> 16;
+        out[tx++] = profile[i] >> 8;
+        out[tx++] = profile[i];
+    }
+    return tx;
+}
+
+#endif
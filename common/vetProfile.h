@@ -0,0 +1,57 @@
+/*******************************************************************************
+*   Ledger Blue
+*   (c) 2016 Ledger
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#ifndef _VET_PROFILE_H_
+#define _VET_PROFILE_H_
+
+#include "os.h"
+
+/* Stages marked by PROFILE=1 builds, keep in sync with PROFILE_STAGES in tests/vechain_client.py */
+typedef enum profileStage_e {
+    PROFILE_PATH = 0,
+    PROFILE_PARSE,
+    PROFILE_HASH,
+    PROFILE_FORMAT_AMOUNT,
+    PROFILE_FORMAT_FEE,
+    PROFILE_DERIVE,
+    PROFILE_SIGN,
+    PROFILE_STAGE_COUNT
+} profileStage_e;
+
+// Serialized breakdown: for each stage, number of runs
+#define PROFILE_RECORD_LENGTH 4
+
+#ifdef HAVE_VET_PROFILE
+
+void vet_profile_reset(void);
+void vet_profile_begin(profileStage_e stage);
+void vet_profile_end(profileStage_e stage);
+uint32_t vet_profile_dump(uint8_t *out, uint32_t outLength);
+
+#define PROFILE_RESET() vet_profile_reset()
+#define PROFILE_BEGIN(stage) vet_profile_begin(stage)
+#define PROFILE_END(stage) vet_profile_end(stage)
+
+#else
+
+#define PROFILE_RESET()
+#define PROFILE_BEGIN(stage)
+#define PROFILE_END(stage)
+
+#endif
+
+#endif
@@ -0,0 +1,92 @@
+/*******************************************************************************
+*   Ledger Blue
+*   (c) 2016 Ledger
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#include "vetTrace.h"
+
+#ifdef HAVE_VET_TRACE
+
+#include <string.h>
+
+static traceRecord_t traceRing[TRACE_RING_SIZE];
+// Number of events recorded since the last clear, the ring keeps the last TRACE_RING_SIZE ones
+static uint32_t traceCount;
+
+/**
+ * @brief Records an event in the trace ring, overwriting the oldest one when full.
+ *
+ * @param[in] event Event identifier (traceEvent_e).
+ * @param[in] arg0 First argument of the event.
+ * @param[in] arg1 Second argument of the event.
+ */
+void vet_trace(uint8_t event, uint8_t arg0, uint16_t arg1) {
+    traceRecord_t *record = &traceRing[traceCount % TRACE_RING_SIZE];
+    record->event = event;
+    record->arg0 = arg0;
+    record->arg1 = arg1;
+    record->sequence = traceCount;
+    traceCount++;
+}
+
+/**
+ * @brief Clears the trace ring.
+ */
+void vet_trace_clear(void) {
+    memset(traceRing, 0, sizeof(traceRing));
+    traceCount = 0;
+}
+
+/**
+ * @brief Serializes a page of the trace ring, oldest events first.
+ *
+ * @details The page starts with the number of events recorded since the last clear (4 bytes),
+ * followed by at most TRACE_RECORDS_PER_PAGE records: event (1), arg0 (1), arg1 (2),
+ * sequence number (4), all big endian.
+ *
+ * @param[in] page Page to serialize.
+ * @param[out] out Output buffer.
+ * @param[in] outLength Size of the output buffer.
+ *
+ * @return The size of the page.
+ */
+uint32_t vet_trace_dump(uint8_t page, uint8_t *out, uint32_t outLength) {
+    uint32_t available = (traceCount < TRACE_RING_SIZE ? traceCount : TRACE_RING_SIZE);
+    uint32_t oldest = traceCount - available;
+    uint32_t i = (uint32_t) page * TRACE_RECORDS_PER_PAGE;
+    uint32_t tx = 0;
+
+    if (outLength < 4 + TRACE_RECORDS_PER_PAGE * TRACE_RECORD_LENGTH) {
+        return 0;
+    }
+    out[tx++] = traceCount >> 24;
+    out[tx++] = traceCount >> 16;
+    out[tx++] = traceCount >> 8;
+    out[tx++] = traceCount;
+    for (; (i < available) && (i < (uint32_t) (page + 1) * TRACE_RECORDS_PER_PAGE); i++) {
+        traceRecord_t *record = &traceRing[(oldest + i) % TRACE_RING_SIZE];
+        out[tx++] = record->event;
+        out[tx++] = record->arg0;
+        out[tx++] = record->arg1 >> 8;
+        out[tx++] = record->arg1;
+        out[tx++] = record->sequence >> 24;
+        out[tx++] = record->sequence >> 16;
+        out[tx++] = record->sequence >> 8;
+        out[tx++] = record->sequence;
+    }
+    return tx;
+}
+
+#endif
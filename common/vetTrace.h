@@ -0,0 +1,78 @@
+/*******************************************************************************
+*   Ledger Blue
+*   (c) 2016 Ledger
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#ifndef _VET_TRACE_H_
+#define _VET_TRACE_H_
+
+#include "os.h"
+
+/* Keep in sync with TRACE_EVENTS in tests/trace_decode.py */
+typedef enum traceEvent_e {
+    TRACE_NONE = 0,
+    // arg0: INS, arg1: data length
+    TRACE_APDU,
+    // arg1: status word
+    TRACE_APDU_DONE,
+    // arg0: rlpTxField_e, arg1: field length
+    TRACE_TX_FIELD,
+    // arg0: clause index, arg1: clause length
+    TRACE_CLAUSE,
+    // arg0: field or parser state, arg1: error code
+    TRACE_PARSE_ERROR,
+    // arg0: parserStatus_e
+    TRACE_TX_RESULT,
+    // arg1: two first bytes of the hash
+    TRACE_HASH_DONE,
+    // arg0: review value formatted, see reviewValue_e
+    TRACE_FORMAT_DONE,
+    // arg0: v, arg1: error
+    TRACE_SIGN_DONE
+} traceEvent_e;
+
+// Parse errors
+#define TRACE_ERROR_PRE_DECODE 1
+#define TRACE_ERROR_PRE_DECODE_LOGIC 2
+#define TRACE_ERROR_DECODE 3
+#define TRACE_ERROR_CONTEXT 4
+
+#ifdef HAVE_VET_TRACE
+
+#define TRACE_RING_SIZE 64
+#define TRACE_RECORD_LENGTH 8
+#define TRACE_RECORDS_PER_PAGE 30
+
+typedef struct traceRecord_t {
+    uint8_t event;
+    uint8_t arg0;
+    uint16_t arg1;
+    // Number of the event since the last clear
+    uint32_t sequence;
+} traceRecord_t;
+
+void vet_trace(uint8_t event, uint8_t arg0, uint16_t arg1);
+void vet_trace_clear(void);
+uint32_t vet_trace_dump(uint8_t page, uint8_t *out, uint32_t outLength);
+
+#define TRACE(event, arg0, arg1) vet_trace((event), (arg0), (arg1))
+
+#else
+
+#define TRACE(event, arg0, arg1)
+
+#endif
+
+#endif
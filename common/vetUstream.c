@@ -18,6 +18,7 @@
 
 #include "vetUstream.h"
 #include "vetUtils.h"
+#include "vetTrace.h"
 
 #define MAX_INT256 32
 #define MAX_INT64 8
@@ -66,7 +67,8 @@ void copyTxDataClauses(txContext_t *context,
     if (result == USTREAM_FAULT) {
         THROW(EXCEPTION);
     }
-    copyTxData(context, NULL, length);
+    // A suspended clauses parser leaves the end of the data to the next call
+    copyTxData(context, NULL, length - clausesContext->commandLength);
 }
 
 void copyTxData(txContext_t *context, uint8_t *out, uint32_t length) {
@@ -88,6 +90,17 @@ void copyTxData(txContext_t *context, uint8_t *out, uint32_t length) {
     }
 }
 
+static void substituteTxData(txContext_t *context, const uint8_t *in, uint32_t length) {
+    if (context->commandLength < length) {
+        PRINTF("substituteTxData Underflow\n");
+        THROW(EXCEPTION);
+    }
+    CX_ASSERT(cx_hash_no_throw((cx_hash_t *)(context->blake2b), 0, in, length, NULL, 0));
+    context->workBuffer += length;
+    context->commandLength -= length;
+    context->currentFieldPos += length;
+}
+
 static void processContent(txContext_t *context) {
     // Keep the full length for sanity checks, move to the next field
     if (!context->currentFieldIsList) {
@@ -253,13 +266,21 @@ static void processDependsOnField(txContext_t *context) {
         PRINTF("Invalid length for TX_RLP_DEPENDSON\n");
         THROW(EXCEPTION);
     }
+    if ((context->dependsOn != NULL) && (context->currentFieldLength != MAX_INT256)) {
+        PRINTF("Missing placeholder for TX_RLP_DEPENDSON\n");
+        THROW(EXCEPTION);
+    }
     if (context->currentFieldPos < context->currentFieldLength) {
         uint32_t copySize =
             (context->commandLength <
                      ((context->currentFieldLength - context->currentFieldPos))
                  ? context->commandLength
                  : context->currentFieldLength - context->currentFieldPos);
-        copyTxData(context, NULL, copySize);
+        if (context->dependsOn != NULL) {
+            substituteTxData(context, context->dependsOn + context->currentFieldPos, copySize);
+        } else {
+            copyTxData(context, NULL, copySize);
+        }
     }
     if (context->currentFieldPos == context->currentFieldLength) {
         context->currentField++;
@@ -290,6 +311,38 @@ static void processNonceField(txContext_t *context) {
     }
 }
 
+static void processFeatures(txContext_t *context) {
+    uint32_t headLength = context->currentFieldLength;
+    uint32_t fieldLength;
+    uint32_t offset;
+    uint32_t i;
+    bool list;
+    bool valid;
+
+    // Empty reserved list, no feature
+    context->content->features = 0;
+    if (context->currentFieldLength == 0) {
+        return;
+    }
+    // Features are the first element of the list, a 32 bits integer
+    if (headLength > sizeof(context->reservedHead)) {
+        headLength = sizeof(context->reservedHead);
+    }
+    if (!rlpCanDecode(context->reservedHead, headLength, &valid) || !valid ||
+        !rlpDecodeLength(context->reservedHead, headLength, &fieldLength, &offset, &list)) {
+        PRINTF("Invalid reserved features\n");
+        THROW(EXCEPTION);
+    }
+    if (list || (fieldLength > MAX_INT32) || (offset + fieldLength > headLength)) {
+        PRINTF("Invalid reserved features\n");
+        THROW(EXCEPTION);
+    }
+    for (i = 0; i < fieldLength; i++) {
+        context->content->features =
+            (context->content->features << 8) | context->reservedHead[offset + i];
+    }
+}
+
 static void processReservedField(txContext_t *context) {
     if (!context->currentFieldIsList) {
         PRINTF("Invalid type for TX_RLP_RESERVED\n");
@@ -301,9 +354,18 @@ static void processReservedField(txContext_t *context) {
                      ((context->currentFieldLength - context->currentFieldPos))
                  ? context->commandLength
                  : context->currentFieldLength - context->currentFieldPos);
+        if (context->currentFieldPos < sizeof(context->reservedHead)) {
+            uint32_t headSize = sizeof(context->reservedHead) - context->currentFieldPos;
+            if (headSize > copySize) {
+                headSize = copySize;
+            }
+            memmove(context->reservedHead + context->currentFieldPos,
+                    context->workBuffer, headSize);
+        }
         copyTxData(context, NULL, copySize);
     }
     if (context->currentFieldPos == context->currentFieldLength) {
+        processFeatures(context);
         context->currentField++;
         context->processingField = false;
     }
@@ -329,7 +391,7 @@ static parserStatus_e processTxInternal(txContext_t *context, clausesContext_t *
                                  &valid)) {
                     // Can decode now, if valid
                     if (!valid) {
-                        PRINTF("RLP pre-decode error\n");
+                        TRACE(TRACE_PARSE_ERROR, context->currentField, TRACE_ERROR_PRE_DECODE);
                         return USTREAM_FAULT;
                     }
                     canDecode = true;
@@ -338,7 +400,7 @@ static parserStatus_e processTxInternal(txContext_t *context, clausesContext_t *
                 // Cannot decode yet
                 // Sanity check
                 if (context->rlpBufferPos == sizeof(context->rlpBuffer)) {
-                    PRINTF("RLP pre-decode logic error\n");
+                    TRACE(TRACE_PARSE_ERROR, context->currentField, TRACE_ERROR_PRE_DECODE_LOGIC);
                     return USTREAM_FAULT;
                 }
             }
@@ -349,7 +411,7 @@ static parserStatus_e processTxInternal(txContext_t *context, clausesContext_t *
             if (!rlpDecodeLength(context->rlpBuffer, context->rlpBufferPos,
                                  &context->currentFieldLength, &offset,
                                  &context->currentFieldIsList)) {
-                PRINTF("RLP decode error\n");
+                TRACE(TRACE_PARSE_ERROR, context->currentField, TRACE_ERROR_DECODE);
                 return USTREAM_FAULT;
             }
             if (offset == 0) {
@@ -363,6 +425,7 @@ static parserStatus_e processTxInternal(txContext_t *context, clausesContext_t *
             context->currentFieldPos = 0;
             context->rlpBufferPos = 0;
             context->processingField = true;
+            TRACE(TRACE_TX_FIELD, context->currentField, context->currentFieldLength);
         }   
         switch (context->currentField) {
             case TX_RLP_CONTENT:
@@ -396,9 +459,13 @@ static parserStatus_e processTxInternal(txContext_t *context, clausesContext_t *
                 processReservedField(context);
                 break;
             default:
-                PRINTF("Invalid RLP decoder context\n");
+                TRACE(TRACE_PARSE_ERROR, context->currentField, TRACE_ERROR_CONTEXT);
                 return USTREAM_FAULT;
         }
+        if (clausesContext->suspended) {
+            // Resumed with the data left in workBuffer and commandLength
+            return USTREAM_SUSPENDED;
+        }
     }
 }
 
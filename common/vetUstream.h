@@ -25,6 +25,9 @@
 
 struct txContext_t;
 
+// VIP-191 fee delegation, bit 0 of reserved.features
+#define TX_FEATURE_DELEGATION 0x01
+
 typedef enum rlpTxField_e {
     TX_RLP_NONE = 0,
     TX_RLP_CONTENT,
@@ -44,6 +47,7 @@ typedef struct txContent_t {
     txInt256_t gaspricecoef;
     txInt256_t gas;
     clausesContent_t *clauses;
+    uint32_t features;
 } txContent_t;
 
 typedef struct txContext_t {
@@ -61,6 +65,10 @@ typedef struct txContext_t {
     uint32_t commandLength;
     txContent_t *content;
     void *extra;
+    // Beginning of the reserved list, enough to decode the features
+    uint8_t reservedHead[5];
+    // When set, hashed instead of the 32 bytes dependsOn placeholder
+    const uint8_t *dependsOn;
 } txContext_t;
 
 void initTx(txContext_t *context, txContent_t *content,
@@ -264,3 +264,14 @@ bool adjustDecimals(char *src, uint32_t srcLength, char *target,
     }
     return true;
 }
+
+#define FNV_OFFSET_BASIS 0x811C9DC5
+#define FNV_PRIME 0x01000193
+
+uint32_t addressHash(const uint8_t *address) {
+    uint32_t hash = FNV_OFFSET_BASIS;
+    for (uint32_t i = 0; i < 20; i++) {
+        hash = (hash ^ address[i]) * FNV_PRIME;
+    }
+    return hash;
+}
@@ -44,3 +44,11 @@ void getVetAddressStringFromBinary(uint8_t *address, uint8_t *out);
 
 bool adjustDecimals(char *src, uint32_t srcLength, char *target,
                     uint32_t targetLength, uint8_t decimals);
+
+/**
+ * @brief Hash of an address, for the tables indexed by address (FNV-1a, the
+ * contract addresses not being uniformly distributed)
+ * @param [in] address 20 bytes address
+ * @return the 32 bits hash of the address
+ */
+uint32_t addressHash(const uint8_t *address);
@@ -0,0 +1,172 @@
+/*******************************************************************************
+*   Ledger Blue
+*   (c) 2016 Ledger
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#include <string.h>
+#include "addressBook.h"
+#include "vetUtils.h"
+
+// Erased with the application, all the slots are empty after its installation
+const addressBook_t N_addressBook_real;
+
+/**
+ * @brief Probes the slots of an address, from the slot given by its hash.
+ *
+ * @param[in] address Address looked for.
+ * @param[out] freeSlot First empty or removed slot of the probe sequence, past the slot of
+ * the address when none precedes it, or ADDRESS_BOOK_SLOTS when there is none. May be NULL.
+ *
+ * @return The slot of the address, or ADDRESS_BOOK_SLOTS when it is not in the book.
+ */
+static uint16_t address_book_find(const uint8_t *address, uint16_t *freeSlot)
+{
+    uint16_t slot = addressHash(address) & (ADDRESS_BOOK_SLOTS - 1);
+    uint16_t found = ADDRESS_BOOK_SLOTS;
+    uint16_t probes;
+
+    if (freeSlot != NULL) {
+        *freeSlot = ADDRESS_BOOK_SLOTS;
+    }
+    for (probes = 0; probes < ADDRESS_BOOK_SLOTS; probes++) {
+        volatile addressBookEntry_t *entry = &N_addressBook.slots[slot];
+        if (entry->state == ADDRESS_BOOK_SLOT_USED) {
+            if ((found == ADDRESS_BOOK_SLOTS) && (memcmp((const void *)entry->address, address, 20) == 0)) {
+                found = slot;
+                if ((freeSlot == NULL) || (*freeSlot != ADDRESS_BOOK_SLOTS)) {
+                    break;
+                }
+            }
+        } else {
+            if ((freeSlot != NULL) && (*freeSlot == ADDRESS_BOOK_SLOTS)) {
+                *freeSlot = slot;
+            }
+            if ((entry->state == ADDRESS_BOOK_SLOT_EMPTY) || (found != ADDRESS_BOOK_SLOTS)) {
+                // The end of the probe sequence
+                break;
+            }
+        }
+        slot = (slot + 1) & (ADDRESS_BOOK_SLOTS - 1);
+    }
+    return found;
+}
+
+/**
+ * @brief Frees the slot of a removed or replaced entry.
+ *
+ * @details The slot is kept as a tombstone while the probe sequences of other addresses may
+ * go on past it. When the next slot is empty, no probe sequence does: the slot is emptied,
+ * along with the tombstones just before it.
+ *
+ * @param[in] slot Slot of the entry.
+ */
+static void address_book_retire(uint16_t slot)
+{
+    uint8_t state = ADDRESS_BOOK_SLOT_REMOVED;
+
+    if (N_addressBook.slots[(slot + 1) & (ADDRESS_BOOK_SLOTS - 1)].state != ADDRESS_BOOK_SLOT_EMPTY) {
+        nvm_write((void *)&N_addressBook.slots[slot].state, &state, 1);
+        return;
+    }
+    state = ADDRESS_BOOK_SLOT_EMPTY;
+    do {
+        nvm_write((void *)&N_addressBook.slots[slot].state, &state, 1);
+        slot = (slot - 1) & (ADDRESS_BOOK_SLOTS - 1);
+    } while (N_addressBook.slots[slot].state == ADDRESS_BOOK_SLOT_REMOVED);
+}
+
+/**
+ * @brief Looks for the label of a trusted recipient.
+ *
+ * @param[in] address Address of the recipient.
+ *
+ * @return The label of the address, NUL terminated, or NULL if it is not in the book.
+ */
+const char *address_book_lookup(const uint8_t address[static 20])
+{
+    uint16_t slot = address_book_find(address, NULL);
+
+    if (slot == ADDRESS_BOOK_SLOTS) {
+        return NULL;
+    }
+    return (const char *)N_addressBook.slots[slot].label;
+}
+
+/**
+ * @brief Tells whether no more address can be added.
+ */
+bool address_book_full(void)
+{
+    return N_addressBook.count >= ADDRESS_BOOK_MAX_ENTRIES;
+}
+
+/**
+ * @brief Adds an address to the book, or changes its label if it is already there.
+ *
+ * @details The entry is written to a free slot before its state, so that an interrupted
+ * write never leaves a used slot with a partial label. A former entry of the address is
+ * only retired once the new one is complete.
+ *
+ * @param[in] address Address of the recipient.
+ * @param[in] label Label of the recipient, at most ADDRESS_BOOK_LABEL_LENGTH characters.
+ *
+ * @return False if the address is new and the book is full.
+ */
+bool address_book_add(const uint8_t address[static 20], const char *label)
+{
+    addressBookEntry_t entry;
+    uint16_t freeSlot;
+    uint16_t slot = address_book_find(address, &freeSlot);
+    uint16_t count = N_addressBook.count;
+
+    if (((slot == ADDRESS_BOOK_SLOTS) && address_book_full()) || (freeSlot == ADDRESS_BOOK_SLOTS)) {
+        return false;
+    }
+    memset(&entry, 0, sizeof(entry));
+    memmove(entry.address, address, 20);
+    strncpy(entry.label, label, ADDRESS_BOOK_LABEL_LENGTH);
+    entry.state = N_addressBook.slots[freeSlot].state;
+    nvm_write((void *)&N_addressBook.slots[freeSlot], &entry, sizeof(entry));
+    entry.state = ADDRESS_BOOK_SLOT_USED;
+    nvm_write((void *)&N_addressBook.slots[freeSlot].state, &entry.state, 1);
+    if (slot != ADDRESS_BOOK_SLOTS) {
+        address_book_retire(slot);
+        return true;
+    }
+    count++;
+    nvm_write((void *)&N_addressBook.count, &count, sizeof(count));
+    return true;
+}
+
+/**
+ * @brief Removes an address from the book.
+ *
+ * @param[in] address Address of the recipient.
+ *
+ * @return False if the address is not in the book.
+ */
+bool address_book_remove(const uint8_t address[static 20])
+{
+    uint16_t slot = address_book_find(address, NULL);
+    uint16_t count = N_addressBook.count;
+
+    if (slot == ADDRESS_BOOK_SLOTS) {
+        return false;
+    }
+    address_book_retire(slot);
+    count--;
+    nvm_write((void *)&N_addressBook.count, &count, sizeof(count));
+    return true;
+}
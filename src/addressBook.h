@@ -0,0 +1,55 @@
+/*******************************************************************************
+*   Ledger Blue
+*   (c) 2016 Ledger
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#ifndef _ADDRESS_BOOK_H_
+#define _ADDRESS_BOOK_H_
+
+#include "os.h"
+#include <stdbool.h>
+
+/* Open addressed table of the trusted recipients, the slot of an address being given by
+   the hash of its 20 bytes. The table is kept at most 3/4 full for short probe sequences. */
+#define ADDRESS_BOOK_SLOTS 256
+#define ADDRESS_BOOK_MAX_ENTRIES 192
+// Printable ASCII characters of a label
+#define ADDRESS_BOOK_LABEL_LENGTH 20
+
+// State of a slot, a removed entry is kept as a tombstone while probing may go on past it
+#define ADDRESS_BOOK_SLOT_EMPTY 0x00
+#define ADDRESS_BOOK_SLOT_USED 0x01
+#define ADDRESS_BOOK_SLOT_REMOVED 0x02
+
+typedef struct addressBookEntry_t {
+    uint8_t state;
+    uint8_t address[20];
+    char label[ADDRESS_BOOK_LABEL_LENGTH + 1];
+} addressBookEntry_t;
+
+typedef struct addressBook_t {
+    addressBookEntry_t slots[ADDRESS_BOOK_SLOTS];
+    uint16_t count;
+} addressBook_t;
+
+extern const addressBook_t N_addressBook_real;
+#define N_addressBook (*(volatile addressBook_t *)PIC(&N_addressBook_real))
+
+const char *address_book_lookup(const uint8_t address[static 20]);
+bool address_book_full(void);
+bool address_book_add(const uint8_t address[static 20], const char *label);
+bool address_book_remove(const uint8_t address[static 20]);
+
+#endif
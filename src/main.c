@@ -20,10 +20,16 @@
 #include "cx.h"
 #include "stdbool.h"
 #include "vetUstream.h"
+#include "vetCertificateUstream.h"
 #include "vetUtils.h"
 #include "vetDisplay.h"
 #include "uint256.h"
 #include "tokens.h"
+#include "tokenCache.h"
+#include "addressBook.h"
+#include "stats.h"
+#include "vetTrace.h"
+#include "vetProfile.h"
 
 #include "os_io_seproxyhal.h"
 #include <string.h>
@@ -46,12 +52,36 @@ uint32_t set_result_get_publicKey(void);
 #define INS_GET_APP_CONFIGURATION 0x06
 #define INS_SIGN_PERSONAL_MESSAGE 0x08
 #define INS_SIGN_CERTIFICATE 0x09
+#define INS_GET_LAST_RESPONSE 0x0A
+#define INS_GET_STATS 0x0B
+#define INS_GET_TRACE 0x0C
+#define INS_ADDRESS_BOOK 0x0D
+#define INS_PROVIDE_TOKEN_INFO 0x0E
 #define P1_CONFIRM 0x01
 #define P1_NON_CONFIRM 0x00
 #define P2_NO_CHAINCODE 0x00
 #define P2_CHAINCODE 0x01
 #define P1_FIRST 0x00
 #define P1_MORE 0x80
+#define P1_NEXT_SIGNATURES 0x40
+#define P1_NEXT_TRANSACTION 0x01
+#define P2_SIGN_SINGLE_PATH 0x00
+#define P2_SIGN_MULTI_PATH 0x01
+#define P2_SIGN_DELEGATOR 0x02
+#define P2_SIGN_SEQUENCE 0x03
+#define P2_STATS_READ 0x00
+#define P2_STATS_RESET 0x01
+#define P1_ADDRESS_BOOK_ADD 0x00
+#define P1_ADDRESS_BOOK_REMOVE 0x01
+
+#define MAX_SIGN_PATHS 5
+#define SIGNATURES_PER_RESPONSE 3
+#define MAX_SEQUENCE_LENGTH 4
+#define SEQUENCE_RECORDS_PER_RESPONSE 2
+// Largest signing response, also fits SEQUENCE_RECORDS_PER_RESPONSE records
+#define LAST_RESPONSE_MAX_LENGTH (1 + SIGNATURES_PER_RESPONSE * 65)
+// Leading bytes of a personal message displayed, half of them when displayed in hex
+#define MESSAGE_PREVIEW_LENGTH 160
 
 #define OFFSET_CLA 0
 #define OFFSET_INS 1
@@ -62,6 +92,7 @@ uint32_t set_result_get_publicKey(void);
 
 #define CONFIG_DATA_ENABLED 0x01
 #define CONFIG_MULTICLAUSE_ENABLED 0x01
+#define CONFIG_EXPERT_MODE_ENABLED 0x01
 
 #define DECIMALS_VET 18
 
@@ -78,11 +109,15 @@ uint32_t set_result_get_publicKey(void);
 #define HW_CLA_NOT_SUPPORTED 0x6E00
 #define HW_INS_NOT_SUPPORTED 0x6D00
 #define HW_SECURITY_STATUS_NOT_SATISFIED 0x6982
+#define HW_REFERENCED_DATA_NOT_FOUND 0x6A88
 #define ERROR_TYPE_MASK 0xF000
 #define ERROR_TYPE_HW 0x6000
 
 static const uint8_t TOKEN_TRANSFER_ID[] = {0xa9, 0x05, 0x9c, 0xbb};
+// transfer(address, uint256): the selector and two words
+#define TOKEN_TRANSFER_LENGTH (4 + 32 + 32)
 static const uint8_t TICKER_VET[] = "VET ";
+static const uint8_t TICKER_VTHO[] = "VTHO ";
 
 typedef struct publicKeyContext_t {
     cx_ecfp_public_key_t publicKey;
@@ -95,6 +130,29 @@ typedef struct transactionContext_t {
     uint8_t pathLength;
     uint32_t bip32Path[MAX_BIP32_PATH];
     uint8_t hash[32];
+    uint8_t signMode;
+    union {
+        // Additional paths signing the same hash (P2_SIGN_MULTI_PATH)
+        struct {
+            uint8_t extraPathCount;
+            uint8_t extraPathLength[MAX_SIGN_PATHS - 1];
+            uint32_t extraBip32Path[MAX_SIGN_PATHS - 1][MAX_BIP32_PATH];
+        };
+        // Transactions chained by dependsOn (P2_SIGN_SEQUENCE), hash holds the first one
+        struct {
+            uint8_t sequenceLength;
+            uint8_t sequenceIndex;
+            uint8_t signer[20];
+            uint8_t dependsOn[32];
+            uint8_t sequenceHash[MAX_SEQUENCE_LENGTH - 1][32];
+            uint256_t sequenceFee;
+            // Distinct recipients of the clauses of the sequence, reviewed before its approval
+            uint8_t recipientCount;
+            uint8_t recipients[SEQUENCE_RECIPIENTS_MAX][20];
+        };
+    };
+    // Transaction sender, when signing as the gas payer (P2_SIGN_DELEGATOR)
+    uint8_t origin[20];
 } transactionContext_t;
 
 typedef struct messageSigningContext_t {
@@ -102,14 +160,42 @@ typedef struct messageSigningContext_t {
     uint32_t bip32Path[MAX_BIP32_PATH];
     uint8_t hash[32];
     uint32_t remainingLength;
+    union {
+        // Leading bytes of a personal message, then their text once the message is complete,
+        // followed by "..." when the message does not fit
+        struct {
+            uint16_t previewLength;
+            bool previewTruncated;
+            char preview[MESSAGE_PREVIEW_LENGTH + 4];
+        };
+        // Fields of a certificate displayed
+        certificateContent_t certificate;
+    };
 } messageSigningContext_t;
 
+// Context of GET_PUBLIC_KEY, never shared with the signing session
+publicKeyContext_t publicKeyContext;
+
+/* Entry of the address book under review, written to NVM once approved. Never shared with
+   the signing session either. */
+typedef struct addressBookContext_t {
+    bool remove;
+    uint8_t address[20];
+    char label[ADDRESS_BOOK_LABEL_LENGTH + 1];
+} addressBookContext_t;
+
+addressBookContext_t addressBookContext;
+
+/* Signing session: tmpCtx, displayContext and blake2b belong to the signing instruction
+   recorded in signSessionOwner, from its first data block until the review or an error of
+   this instruction. Other instructions do not end it and may be interleaved with its data blocks. */
 union {
-    publicKeyContext_t publicKeyContext;
     transactionContext_t transactionContext;
     messageSigningContext_t messageSigningContext;
 } tmpCtx;
 
+uint8_t signSessionOwner;
+
 typedef struct txFullContext_t {
     txContext_t txContext;
     clausesContext_t clausesContext;
@@ -119,6 +205,7 @@ typedef struct txFullContext_t {
 union {
     txFullContext_t txFullContext;
     feeComputationContext_t feeComputationContext;
+    certificateContext_t certificateContext;
 } displayContext;
 
 union {
@@ -126,17 +213,125 @@ union {
 } tmpContent;
 clausesContent_t clausesContent;
 clauseContent_t clauseContent;
+/* Fields of the clauses following the first one, for the review of each clause */
+clauseContent_t nextClauseContent;
 
 cx_blake2b_t blake2b;
 volatile char addressSummary[32];
 volatile char fullAddress[43];
-volatile char fullAmount[50];
+// An amount, or a calldata word in hex during the expert review
+volatile char fullAmount[CALLDATA_TEXT_LENGTH];
 volatile char maxFee[60];
 volatile bool dataPresent;
 volatile bool multipleClauses;
 volatile bool skipDataWarning;
 volatile bool skipClausesWarning;
 
+/* Signature computed ahead of the user approval, while the review screens are
+   displayed. It is only released by io_seproxyhal_touch_tx_ok(). */
+typedef struct speculativeSignature_t {
+    bool pending;
+    bool ready;
+    uint8_t sig_r[32];
+    uint8_t sig_s[32];
+    uint8_t v;
+} speculativeSignature_t;
+
+speculativeSignature_t speculativeSignature;
+
+/* Signatures approved by the user and not sent back yet. When more signatures
+   than SIGNATURES_PER_RESPONSE are approved, the host fetches the remaining ones
+   with P1_NEXT_SIGNATURES. Signatures of a sequence are followed by the transaction ID. */
+typedef struct signatureBatch_t {
+    uint8_t count;
+    uint8_t next;
+    bool multiple;
+    bool sequence;
+} signatureBatch_t;
+
+signatureBatch_t signatureBatch;
+
+/* Last signing response sent to the host, kept so that a lost response can be read again
+   with INS_GET_LAST_RESPONSE instead of asking the user to approve the request twice. */
+typedef struct lastResponse_t {
+    bool valid;
+    uint8_t hash[32];
+    uint8_t length;
+    uint8_t data[LAST_RESPONSE_MAX_LENGTH];
+} lastResponse_t;
+
+lastResponse_t lastResponse;
+volatile bool multipleSigners;
+volatile char reviewSubtitle[20];
+
+/* Review values formatted into fullAddress, fullAmount and maxFee, one bit per reviewValue_e.
+   The other ones are formatted by review_value() when their screen is displayed. */
+static uint8_t reviewValuesReady;
+#define REVIEW_VALUE_BIT(value) (1 << (value))
+#define REVIEW_VALUES_ALL                                                            \
+    (REVIEW_VALUE_BIT(REVIEW_VALUE_ADDRESS) | REVIEW_VALUE_BIT(REVIEW_VALUE_AMOUNT) | \
+     REVIEW_VALUE_BIT(REVIEW_VALUE_FEE))
+
+static void review_values_reset(uint8_t ready);
+
+/* Amount sent by the clauses of a transaction, for one asset */
+typedef struct assetTotal_t {
+    // Token sent, NULL for VET
+    const tokenDefinition_t *token;
+    uint256_t amount;
+} assetTotal_t;
+
+/* Totals per asset, accumulated as the clauses are parsed. VET is always the first asset. */
+typedef struct assetTotals_t {
+    uint8_t count;
+    // Tokens sent and not totaled, more assets than REVIEW_TOTALS_MAX being sent
+    bool partial;
+    assetTotal_t assets[REVIEW_TOTALS_MAX];
+} assetTotals_t;
+
+assetTotals_t assetTotals;
+
+#ifdef HAVE_BAGL
+/* Fields of a clause, each one displayed on its own step */
+#define CLAUSE_FIELD_AMOUNT 0
+#define CLAUSE_FIELD_ADDRESS 1
+#define CLAUSE_FIELD_DATA 2
+
+/* Review of a transaction with multiple clauses, each clause being reviewed before the
+   next one is parsed. Only the clause on screen is kept, and the field on screen is formatted
+   into reviewTitle and fullAmount when its step is displayed, whatever the number of clauses. */
+typedef struct clauseReview_t {
+    bool active;
+    // The first clause carries data, warned about before the clauses
+    bool dataWarning;
+    // A field of the clause is on screen, as opposed to the steps around the clause
+    bool inside;
+    // The whole transaction has been parsed
+    bool complete;
+    // The totals per asset are on screen, in place of a clause
+    bool totals;
+    // The recipients and totals of a sequence, reviewed after its last transaction
+    bool sequence;
+    uint16_t index;
+    uint8_t field;
+    uint8_t fieldCount;
+    clauseContent_t *content;
+} clauseReview_t;
+
+clauseReview_t clauseReview;
+
+/* Expert review of the data of a transaction with a single clause, the page on screen being
+   formatted into reviewTitle and fullAmount when its step is displayed */
+typedef struct calldataReview_t {
+    // A page of the data is on screen, as opposed to the steps around the data
+    bool inside;
+    uint8_t page;
+} calldataReview_t;
+
+calldataReview_t calldataReview;
+volatile char reviewTitle[24];
+#endif
+
 #ifdef HAVE_BAGL
 bagl_element_t tmp_element;
 #endif
@@ -253,12 +448,47 @@ void settings_clause_selector(unsigned int idx) {
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////
+// Expert mode submenu:
+
+void settings_expert_change(uint8_t enabled) {
+    nvm_write((void *)&N_storage.expertMode, &enabled, 1);
+    ui_idle();
+}
+
+const char* const settings_expert_getter_values[] = {
+  "No",
+  "Yes",
+  "Back"
+};
+
+const char* settings_expert_getter(unsigned int idx) {
+  if (idx < ARRAYLEN(settings_expert_getter_values)) {
+    return settings_expert_getter_values[idx];
+  }
+  return NULL;
+}
+
+void settings_expert_selector(unsigned int idx) {
+  switch(idx) {
+    case 0:
+      settings_expert_change(0);
+      break;
+    case 1:
+      settings_expert_change(1);
+      break;
+    default:
+      ux_menulist_init(0, settings_submenu_getter, settings_submenu_selector);
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////
 // Settings menu:
 
 const char* const settings_submenu_getter_values[] = {
   "Contract data",
   "Multi-clause",
+  "Expert mode",
   "Back",
 };
 
@@ -277,6 +507,9 @@ void settings_submenu_selector(unsigned int idx) {
     case 1:
         ux_menulist_init_select(0, settings_clause_getter, settings_clause_selector, N_storage.multiClauseAllowed);
         break;
+    case 2:
+        ux_menulist_init_select(0, settings_expert_getter, settings_expert_selector, N_storage.expertMode);
+        break;
     default:
       ui_idle();
   }
@@ -360,7 +593,7 @@ UX_STEP_NOCB(ux_confirm_full_flow_1_step,
     {
       &C_icon_eye,
       "Review",
-      "transaction",
+      (char *)reviewSubtitle,
     });
 
 // OPTIONNAL
@@ -383,23 +616,26 @@ UX_STEP_NOCB(
 
 // OPTIONNAL
 
-UX_STEP_NOCB(
+UX_STEP_NOCB_INIT(
     ux_confirm_full_flow_2_step,
     bnnn_paging,
+    review_value(REVIEW_VALUE_AMOUNT),
     {
       .title = "Amount",
       .text = (char *)fullAmount
     });
-UX_STEP_NOCB(
+UX_STEP_NOCB_INIT(
     ux_confirm_full_flow_3_step,
     bnnn_paging,
+    review_value(REVIEW_VALUE_ADDRESS),
     {
       .title = "Address",
       .text = (char *)fullAddress,
     });
-UX_STEP_NOCB(
+UX_STEP_NOCB_INIT(
     ux_confirm_full_flow_4_step,
     bnnn_paging,
+    review_value(REVIEW_VALUE_FEE),
     {
       .title = "Max Fees",
       .text = (char *)maxFee,
@@ -442,30 +678,188 @@ UX_FLOW(ux_confirm_full_data_flow,
   &ux_confirm_full_flow_6_step
 );
 
-UX_FLOW(ux_confirm_full_clauses_flow,
+static void clause_review_step(bool upper);
+static void clause_review_totals(void);
+static unsigned int clause_review_reject(bool replyPending);
+
+UX_STEP_INIT(
+    ux_confirm_clause_upper_step,
+    NULL,
+    NULL,
+    {
+      clause_review_step(true);
+    });
+UX_STEP_NOCB(
+    ux_confirm_clause_step,
+    bnnn_paging,
+    {
+      .title = (char *)reviewTitle,
+      .text = (char *)fullAmount,
+    });
+UX_STEP_INIT(
+    ux_confirm_clause_lower_step,
+    NULL,
+    NULL,
+    {
+      clause_review_step(false);
+    });
+UX_STEP_VALID(
+    ux_confirm_clause_reject_step,
+    pb,
+    clause_review_reject(true),
+    {
+      &C_icon_crossmark,
+      "Reject",
+    });
+// confirm_clauses: confirm transaction / Clause i: Amount, Address, Data / Total per asset / MaxFees: maxFee
+static void calldata_review_step(bool upper);
+
+UX_STEP_INIT(
+    ux_confirm_calldata_upper_step,
+    NULL,
+    NULL,
+    {
+      calldata_review_step(true);
+    });
+UX_STEP_INIT(
+    ux_confirm_calldata_lower_step,
+    NULL,
+    NULL,
+    {
+      calldata_review_step(false);
+    });
+// confirm_full_calldata: confirm_full / Data page by page (expert mode) / MaxFees: maxFee
+UX_FLOW(ux_confirm_full_calldata_flow,
   &ux_confirm_full_flow_1_step,
-  &ux_confirm_full_warning_clauses_step,
+  &ux_confirm_full_warning_data_step,
   FLOW_BARRIER,
   &ux_confirm_full_flow_2_step,
   &ux_confirm_full_flow_3_step,
+  &ux_confirm_calldata_upper_step,
+  &ux_confirm_clause_step,
+  &ux_confirm_calldata_lower_step,
   &ux_confirm_full_flow_4_step,
   &ux_confirm_full_flow_5_step,
   &ux_confirm_full_flow_6_step
 );
 
-UX_FLOW(ux_confirm_full_data_clauses_flow,
+UX_FLOW(ux_confirm_clauses_flow,
+  &ux_confirm_full_flow_1_step,
+  &ux_confirm_full_warning_clauses_step,
+  FLOW_BARRIER,
+  &ux_confirm_clause_upper_step,
+  &ux_confirm_clause_step,
+  &ux_confirm_clause_lower_step,
+  &ux_confirm_full_flow_4_step,
+  &ux_confirm_full_flow_5_step,
+  &ux_confirm_clause_reject_step
+);
+
+UX_FLOW(ux_confirm_data_clauses_flow,
   &ux_confirm_full_flow_1_step,
   &ux_confirm_full_warning_data_step,
   FLOW_BARRIER,
   &ux_confirm_full_warning_clauses_step,
   FLOW_BARRIER,
-  &ux_confirm_full_flow_2_step,
-  &ux_confirm_full_flow_3_step,
+  &ux_confirm_clause_upper_step,
+  &ux_confirm_clause_step,
+  &ux_confirm_clause_lower_step,
+  &ux_confirm_full_flow_4_step,
+  &ux_confirm_full_flow_5_step,
+  &ux_confirm_clause_reject_step
+);
+
+// Displayed while the host sends the data block of the next clause, whose reply has been sent
+UX_STEP_NOCB(
+    ux_confirm_clause_wait_step,
+    nn,
+    {
+      "Loading",
+      "next clause",
+    });
+UX_STEP_VALID(
+    ux_confirm_clause_wait_reject_step,
+    pb,
+    clause_review_reject(false),
+    {
+      &C_icon_crossmark,
+      "Reject",
+    });
+UX_FLOW(ux_confirm_clause_wait_flow,
+  &ux_confirm_clause_wait_step,
+  &ux_confirm_clause_wait_reject_step
+);
+
+
+UX_STEP_NOCB(ux_confirm_delegation_flow_1_step,
+    pnn,
+    {
+      &C_icon_eye,
+      "Review",
+      "gas payment",
+    });
+UX_STEP_NOCB(
+    ux_confirm_delegation_flow_2_step,
+    bnnn_paging,
+    {
+      .title = "Gas payer for",
+      .text = (char *)fullAddress,
+    });
+// confirm_delegation: sign as the gas payer / Gas payer for: fullAddress / MaxFees: maxFee
+UX_FLOW(ux_confirm_delegation_flow,
+  &ux_confirm_delegation_flow_1_step,
+  &ux_confirm_delegation_flow_2_step,
   &ux_confirm_full_flow_4_step,
   &ux_confirm_full_flow_5_step,
   &ux_confirm_full_flow_6_step
 );
 
+UX_STEP_NOCB(ux_confirm_sequence_flow_1_step,
+    pnn,
+    {
+      &C_icon_eye,
+      "Review",
+      (char *)reviewSubtitle,
+    });
+UX_STEP_NOCB(
+    ux_confirm_sequence_flow_2_step,
+    bnnn_paging,
+    {
+      .title = "From",
+      .text = (char *)fullAddress,
+    });
+UX_STEP_NOCB(
+    ux_confirm_sequence_flow_3_step,
+    bnnn_paging,
+    {
+      .title = "Total Max Fees",
+      .text = (char *)maxFee,
+    });
+// confirm_sequence: N transactions / From: fullAddress / To i, Total per asset / Total Max Fees: maxFee
+UX_FLOW(ux_confirm_sequence_flow,
+  &ux_confirm_sequence_flow_1_step,
+  &ux_confirm_sequence_flow_2_step,
+  &ux_confirm_clause_upper_step,
+  &ux_confirm_clause_step,
+  &ux_confirm_clause_lower_step,
+  &ux_confirm_sequence_flow_3_step,
+  &ux_confirm_full_flow_5_step,
+  &ux_confirm_full_flow_6_step
+);
+
+UX_FLOW(ux_confirm_data_sequence_flow,
+  &ux_confirm_sequence_flow_1_step,
+  &ux_confirm_full_warning_data_step,
+  FLOW_BARRIER,
+  &ux_confirm_sequence_flow_2_step,
+  &ux_confirm_clause_upper_step,
+  &ux_confirm_clause_step,
+  &ux_confirm_clause_lower_step,
+  &ux_confirm_sequence_flow_3_step,
+  &ux_confirm_full_flow_5_step,
+  &ux_confirm_full_flow_6_step
+);
+
 
 //////////////////////////////////////////////////////////////////////
 UX_STEP_NOCB(
@@ -509,6 +903,22 @@ UX_FLOW(ux_sign_msg_flow,
   &ux_sign_msg_flow_4_step
 );
 
+UX_STEP_NOCB(
+    ux_sign_msg_preview_step,
+    bnnn_paging,
+    {
+      .title = "Message",
+      .text = tmpCtx.messageSigningContext.preview,
+    });
+// sign_msg_preview: sign message / Message: leading bytes as text or hex / Message hash: fullAddress
+UX_FLOW(ux_sign_msg_preview_flow,
+  &ux_sign_msg_flow_1_step,
+  &ux_sign_msg_preview_step,
+  &ux_sign_msg_flow_2_step,
+  &ux_sign_msg_flow_3_step,
+  &ux_sign_msg_flow_4_step
+);
+
 UX_STEP_NOCB(
     ux_sign_cert_flow_1_step,
     pnn,
@@ -534,8 +944,71 @@ UX_STEP_VALID(
       "certificate",
     });
 
+UX_STEP_NOCB(
+    ux_sign_cert_purpose_step,
+    bnnn_paging,
+    {
+      .title = "Purpose",
+      .text = tmpCtx.messageSigningContext.certificate.purpose,
+    });
+UX_STEP_NOCB(
+    ux_sign_cert_domain_step,
+    bnnn_paging,
+    {
+      .title = "Domain",
+      .text = tmpCtx.messageSigningContext.certificate.domain,
+    });
+UX_STEP_NOCB(
+    ux_sign_cert_type_step,
+    bnnn_paging,
+    {
+      .title = "Type",
+      .text = tmpCtx.messageSigningContext.certificate.payloadType,
+    });
+UX_STEP_NOCB(
+    ux_sign_cert_content_step,
+    bnnn_paging,
+    {
+      .title = "Content",
+      .text = tmpCtx.messageSigningContext.certificate.payloadContent,
+    });
+UX_STEP_NOCB(
+    ux_sign_cert_timestamp_step,
+    bnnn_paging,
+    {
+      .title = "Timestamp",
+      .text = tmpCtx.messageSigningContext.certificate.timestamp,
+    });
+UX_STEP_NOCB(
+    ux_sign_cert_signer_step,
+    bnnn_paging,
+    {
+      .title = "Signer",
+      .text = tmpCtx.messageSigningContext.certificate.signer,
+    });
+
+// sign_cert: sign certificate / Purpose, Domain, Type, Content, Timestamp / Certificate hash: fullAddress
 UX_FLOW(ux_sign_cert_flow,
   &ux_sign_cert_flow_1_step,
+  &ux_sign_cert_purpose_step,
+  &ux_sign_cert_domain_step,
+  &ux_sign_cert_type_step,
+  &ux_sign_cert_content_step,
+  &ux_sign_cert_timestamp_step,
+  &ux_sign_cert_flow_2_step,
+  &ux_sign_cert_flow_3_step,
+  &ux_sign_msg_flow_4_step
+);
+
+// sign_cert_signer: the same, with the Signer of the certificate after its Timestamp
+UX_FLOW(ux_sign_cert_signer_flow,
+  &ux_sign_cert_flow_1_step,
+  &ux_sign_cert_purpose_step,
+  &ux_sign_cert_domain_step,
+  &ux_sign_cert_type_step,
+  &ux_sign_cert_content_step,
+  &ux_sign_cert_timestamp_step,
+  &ux_sign_cert_signer_step,
   &ux_sign_cert_flow_2_step,
   &ux_sign_cert_flow_3_step,
   &ux_sign_msg_flow_4_step
@@ -543,6 +1016,57 @@ UX_FLOW(ux_sign_cert_flow,
 
 //////////////////////////////////////////////////////////////////////
 
+UX_STEP_NOCB(
+    ux_address_book_add_step,
+    pnn,
+    {
+      &C_icon_eye,
+      "Add to",
+      "address book",
+    });
+UX_STEP_NOCB(
+    ux_address_book_remove_step,
+    pnn,
+    {
+      &C_icon_eye,
+      "Remove from",
+      "address book",
+    });
+UX_STEP_NOCB(
+    ux_address_book_label_step,
+    bnnn_paging,
+    {
+      .title = "Label",
+      .text = addressBookContext.label,
+    });
+UX_STEP_VALID(
+    ux_address_book_approve_step,
+    pb,
+    io_seproxyhal_touch_address_book_ok(),
+    {
+      &C_icon_validate_14,
+      "Approve",
+    });
+// address_book_add: add to address book / Label / Address: fullAddress
+UX_FLOW(ux_address_book_add_flow,
+  &ux_address_book_add_step,
+  &ux_address_book_label_step,
+  &ux_display_public_flow_5_step,
+  &ux_address_book_approve_step,
+  &ux_display_public_flow_7_step
+);
+
+// address_book_remove: the same, removing the entry
+UX_FLOW(ux_address_book_remove_flow,
+  &ux_address_book_remove_step,
+  &ux_address_book_label_step,
+  &ux_display_public_flow_5_step,
+  &ux_address_book_approve_step,
+  &ux_display_public_flow_7_step
+);
+
+//////////////////////////////////////////////////////////////////////
+
 void ui_idle(void) {
     skipDataWarning = false;
     skipClausesWarning = false;
@@ -591,6 +1115,7 @@ int crypto_derive_private_key(cx_ecfp_private_key_t *private_key,
     uint8_t raw_private_key[64] = {0};
     int error = 0;
 
+    PROFILE_BEGIN(PROFILE_DERIVE);
     // Derive the raw private key and chain code using the BIP32 path
     error = os_derive_bip32_no_throw(CX_CURVE_256K1,
                                      bip32_path,
@@ -611,6 +1136,7 @@ int crypto_derive_private_key(cx_ecfp_private_key_t *private_key,
 
     // Clear the raw private key from memory after use for security
     explicit_bzero(&raw_private_key, sizeof(raw_private_key));
+    PROFILE_END(PROFILE_DERIVE);
     return error;
 }
 
@@ -651,13 +1177,19 @@ cx_err_t crypto_init_public_key(cx_ecfp_private_key_t *private_key,
  * - Determines the V component based on the signature information.
  * - Clears the private key from memory after use for security.
  *
+ * @param[in] bip32Path Pointer to the BIP32 path of the signing key.
+ * @param[in] pathLength Length of the BIP32 path.
+ * @param[in] hash Hash to sign.
  * @param[out] sig_r Pointer to store the R component of the signature.
  * @param[out] sig_s Pointer to store the S component of the signature.
  * @param[out] v Pointer to store the V component of the signature.
  *
  * @return Error code indicating the success or failure of the operation.
  */
-int crypto_sign_message(uint8_t sig_r[static 32], uint8_t sig_s[static 32], uint8_t v[static 1])
+int crypto_sign_message(const uint32_t bip32Path[static MAX_BIP32_PATH],
+                        uint8_t pathLength,
+                        const uint8_t hash[static 32],
+                        uint8_t sig_r[static 32], uint8_t sig_s[static 32], uint8_t v[static 1])
 {
     cx_ecfp_private_key_t private_key = {0};
     uint32_t info = 0;
@@ -668,30 +1200,29 @@ int crypto_sign_message(uint8_t sig_r[static 32], uint8_t sig_s[static 32], uint
     // derive private key according to BIP32 path
     int error = crypto_derive_private_key(&private_key,
                                           NULL,
-                                          tmpCtx.transactionContext.bip32Path,
-                                          tmpCtx.transactionContext.pathLength);
+                                          bip32Path,
+                                          pathLength);
                                           
     if (error != 0) {
         return error;
     }
 
     // Sign the message using the private key
+    PROFILE_BEGIN(PROFILE_SIGN);
     error = cx_ecdsa_sign_rs_no_throw(
         &private_key,
         CX_RND_RFC6979 | CX_LAST,
         CX_SHA256,
-        tmpCtx.messageSigningContext.hash,
-        sizeof(tmpCtx.messageSigningContext.hash),
+        hash,
+        32,
         32,
         sig_r,
         sig_s,
         &info);
+    PROFILE_END(PROFILE_SIGN);
 
     // Clear the private key from memory after use for security
     explicit_bzero(&private_key, sizeof(private_key));
-    PRINTF("Signature: %.*H\n", 32, sig_r);
-    PRINTF("%.*H\n", 32, sig_s);
-    PRINTF("%.*H\n", 1, &info);
 
     // Determine the V component based on the signature information
     if (error == 0) 
@@ -700,11 +1231,106 @@ int crypto_sign_message(uint8_t sig_r[static 32], uint8_t sig_s[static 32], uint
             v[0] |= 0x01;
         }
     }
-    PRINTF("%.*H\n", 1, v);
+    TRACE(TRACE_SIGN_DONE, v[0], error);
 
     return error;
 }
 
+/**
+ * @brief Starts a signing session owned by a signing instruction.
+ *
+ * @details Called on the first data block, before anything is written to the session context,
+ * so that the previous session cannot be continued with a partially overwritten context.
+ *
+ * @param[in] ins Instruction starting the session.
+ */
+void sign_session_start(uint8_t ins)
+{
+    signSessionOwner = ins;
+    PROFILE_RESET();
+}
+
+/**
+ * @brief Checks that a following data block belongs to the running signing session.
+ *
+ * @param[in] ins Instruction of the data block.
+ */
+void sign_session_check(uint8_t ins)
+{
+    if ((signSessionOwner == 0) || (signSessionOwner != ins)) {
+        PRINTF("No signing session for this instruction\n");
+        THROW(HW_SW_TRANSACTION_CANCELLED);
+    }
+}
+
+/**
+ * @brief Ends the signing session and wipes the parser context.
+ *
+ * @details The signatures approved by the user are still available through the signature batch.
+ */
+void sign_session_end(void)
+{
+    signSessionOwner = 0;
+    memset(&displayContext, 0, sizeof(displayContext));
+}
+
+/**
+ * @brief Tells whether an APDU belongs to a signing session, as opposed to a stateless query.
+ *
+ * @param[in] ins Instruction of the APDU.
+ *
+ * @return True for the signing instructions.
+ */
+static bool is_sign_ins(uint8_t ins)
+{
+    return (ins == INS_SIGN) || (ins == INS_SIGN_PERSONAL_MESSAGE) || (ins == INS_SIGN_CERTIFICATE);
+}
+
+/**
+ * @brief Wipes the speculative signature and cancels any pending computation.
+ *
+ * @details Called on rejection, on application exit and whenever a new APDU is received,
+ * so that a signature never outlives the review it was computed for.
+ */
+void speculative_sign_wipe(void)
+{
+    explicit_bzero(&speculativeSignature, sizeof(speculativeSignature));
+}
+
+/**
+ * @brief Requests the signature of the current hash to be computed in the background.
+ *
+ * @details Must be called once the hash to sign is final and the review is about to be
+ * displayed. The signature itself is computed on the next ticker event by speculative_sign_run().
+ */
+void speculative_sign_schedule(void)
+{
+    speculative_sign_wipe();
+    speculativeSignature.pending = true;
+}
+
+/**
+ * @brief Computes the scheduled speculative signature.
+ *
+ * @details Called from the ticker event while the user reviews the request. The result is kept in RAM
+ * and only sent back after the user approval. On error the signature is simply dropped,
+ * io_seproxyhal_touch_tx_ok() will then sign synchronously and report the error.
+ */
+static void speculative_sign_run(void)
+{
+    speculativeSignature.pending = false;
+    if (crypto_sign_message(tmpCtx.transactionContext.bip32Path,
+                            tmpCtx.transactionContext.pathLength,
+                            tmpCtx.transactionContext.hash,
+                            speculativeSignature.sig_r,
+                            speculativeSignature.sig_s,
+                            &speculativeSignature.v) == 0) {
+        speculativeSignature.ready = true;
+    } else {
+        speculative_sign_wipe();
+    }
+}
+
 /**
  * @brief Parses a BIP32 path from a buffer and save it with its path length,
  * updating the buffer pointer and data length.
@@ -731,6 +1357,10 @@ void parseBip32Path(uint8_t **pWorkBuffer, uint16_t dataLength[static 1], uint8_
     if (pWorkBuffer == NULL || *pWorkBuffer == NULL || dataLength == NULL || pathLength == NULL || bip32Path == NULL){
         THROW(HW_TECHNICAL_PROBLEM);
     }
+    if (*dataLength < 1) {
+        THROW(HW_INCORRECT_DATA);
+    }
+    PROFILE_BEGIN(PROFILE_PATH);
     // retrieve the path length
     *pathLength = (*pWorkBuffer)[0];
     if ((*pathLength < 0x01) || (*pathLength > MAX_BIP32_PATH) || *dataLength < 1 + *pathLength * 4){
@@ -749,23 +1379,235 @@ void parseBip32Path(uint8_t **pWorkBuffer, uint16_t dataLength[static 1], uint8_
         (*pWorkBuffer) += 4;
         (*dataLength) -= 4;
     }
+    PROFILE_END(PROFILE_PATH);
 }
-/////////////////////////////////////////////////////////////////////
-
 
 /**
- * @brief Exits the touch operation and returns to the dashboard.
+ * @brief Parses the list of BIP32 paths of a multi-path signature.
  *
- * @details This function exits the touch operation and returns to the dashboard by invoking the operating system scheduler exit function.
- * It follows these steps:
- * - Calls the operating system scheduler exit function to return to the dashboard.
- * - Returns 0 indicating that the widget should not be redrawn.
+ * @details The list is encoded as the number of paths (max MAX_SIGN_PATHS) followed by each path
+ * as expected by parseBip32Path(). The first path is stored in the transaction context as for a
+ * single path signature, the other ones in the additional paths of the context.
  *
- * @return 0 indicating that the widget should not be redrawn.
+ * @param[in,out] pWorkBuffer Pointer to the pointer of the work buffer containing the BIP32 paths + data
+ * @param[in,out] dataLength Pointer to the remaining length of the data in the work buffer.
  */
-unsigned int io_seproxyhal_touch_exit() {
-    // Go back to the dashboard
-    os_sched_exit(0);
+void parseBip32PathList(uint8_t **pWorkBuffer, uint16_t dataLength[static 1])
+{
+    uint8_t pathCount;
+    uint8_t i;
+
+    if (*dataLength < 1) {
+        THROW(HW_INCORRECT_DATA);
+    }
+    pathCount = (*pWorkBuffer)[0];
+    if ((pathCount < 1) || (pathCount > MAX_SIGN_PATHS)) {
+        PRINTF("Invalid path count\n");
+        THROW(HW_INCORRECT_DATA);
+    }
+    (*pWorkBuffer)++;
+    (*dataLength)--;
+
+    parseBip32Path(pWorkBuffer, dataLength, &tmpCtx.transactionContext.pathLength, tmpCtx.transactionContext.bip32Path);
+    for (i = 0; i < pathCount - 1; i++) {
+        parseBip32Path(pWorkBuffer, dataLength,
+                       &tmpCtx.transactionContext.extraPathLength[i],
+                       tmpCtx.transactionContext.extraBip32Path[i]);
+    }
+    tmpCtx.transactionContext.extraPathCount = pathCount - 1;
+}
+
+/**
+ * @brief Prepares the batch of signatures to send back once the user approves the request.
+ *
+ * @param[in] count Number of signatures approved by the user.
+ * @param[in] multiple True if the responses are prefixed by the number of remaining signatures.
+ */
+void signature_batch_init(uint8_t count, bool multiple)
+{
+    signatureBatch.count = count;
+    signatureBatch.next = 0;
+    signatureBatch.multiple = multiple;
+    signatureBatch.sequence = false;
+}
+
+/**
+ * @brief Returns the hash signed by a signature of the batch.
+ *
+ * @param[in] index Index of the signature in the batch.
+ *
+ * @return The hash of the transaction of the sequence, or the common hash otherwise.
+ */
+static const uint8_t *batch_hash(uint8_t index)
+{
+    if (signatureBatch.sequence && (index != 0)) {
+        return tmpCtx.transactionContext.sequenceHash[index - 1];
+    }
+    return tmpCtx.transactionContext.hash;
+}
+
+/**
+ * @brief Computes the ID of a transaction signed by the sequence signer.
+ *
+ * @details The ID is blake2b(signingHash || signerAddress), as referenced by dependsOn.
+ *
+ * @param[in] hash Signing hash of the transaction.
+ * @param[out] txId Buffer to store the transaction ID.
+ */
+static void compute_tx_id(const uint8_t hash[static 32], uint8_t txId[static 32])
+{
+    CX_ASSERT(cx_blake2b_init_no_throw(&blake2b, 256));
+    CX_ASSERT(cx_hash_no_throw((cx_hash_t *)&blake2b, 0, hash, 32, NULL, 0));
+    CX_ASSERT(cx_hash_no_throw((cx_hash_t *)&blake2b, CX_LAST, tmpCtx.transactionContext.signer,
+                               sizeof(tmpCtx.transactionContext.signer), txId, 32));
+}
+
+/**
+ * @brief Computes a signature of the batch and appends it to the APDU buffer.
+ *
+ * @details The signature of index 0 is taken from the speculative signature if it is ready.
+ * The other ones are signed with the additional paths of the transaction context, or with
+ * the hashes of the following transactions of a sequence.
+ *
+ * @param[in] tx Current size of the APDU buffer.
+ * @param[in] index Index of the signature in the batch.
+ *
+ * @return The new size of the APDU buffer.
+ */
+static uint32_t append_signature(uint32_t tx, uint8_t index)
+{
+    uint8_t sig_r[32];
+    uint8_t sig_s[32];
+    uint8_t v = 0;
+    int error;
+
+    if ((index == 0) && speculativeSignature.ready) {
+        // The signature has already been computed while the user was reviewing
+        memmove(sig_r, speculativeSignature.sig_r, 32);
+        memmove(sig_s, speculativeSignature.sig_s, 32);
+        v = speculativeSignature.v;
+        speculative_sign_wipe();
+    } else {
+        // Do not let a ticker event start the speculative signature now
+        speculative_sign_wipe();
+
+        io_seproxyhal_io_heartbeat();
+        // Sign the message
+        if ((index == 0) || signatureBatch.sequence) {
+            error = crypto_sign_message(tmpCtx.transactionContext.bip32Path,
+                                        tmpCtx.transactionContext.pathLength,
+                                        batch_hash(index),
+                                        sig_r, sig_s, &v);
+        } else {
+            error = crypto_sign_message(tmpCtx.transactionContext.extraBip32Path[index - 1],
+                                        tmpCtx.transactionContext.extraPathLength[index - 1],
+                                        tmpCtx.transactionContext.hash,
+                                        sig_r, sig_s, &v);
+        }
+        io_seproxyhal_io_heartbeat();
+
+        if (error != 0) {
+            memset(&signatureBatch, 0, sizeof(signatureBatch));
+            THROW(error);
+        }
+    }
+
+    // Move signature components to the APDU buffer
+    memmove(G_io_apdu_buffer + tx, sig_r, 32);
+    memmove(G_io_apdu_buffer + tx + 32, sig_s, 32);
+    tx += 64;
+    G_io_apdu_buffer[tx++] = v & 0x01;
+
+    // Clear the signature components from memory after use.
+    memset(sig_r, 0, 32);
+    memset(sig_s, 0, 32);
+    return tx;
+}
+
+/**
+ * @brief Wipes the last signing response.
+ *
+ * @details Called on application exit and when the device is locked.
+ */
+void last_response_wipe(void)
+{
+    explicit_bzero(&lastResponse, sizeof(lastResponse));
+}
+
+/**
+ * @brief Keeps a copy of the signing response written to the APDU buffer.
+ *
+ * @param[in] hash Signing hash of the request, used as the key of the response.
+ * @param[in] length Size of the response in the APDU buffer.
+ */
+static void last_response_store(const uint8_t hash[static 32], uint32_t length)
+{
+    if (length > sizeof(lastResponse.data)) {
+        last_response_wipe();
+        return;
+    }
+    memmove(lastResponse.hash, hash, 32);
+    memmove(lastResponse.data, G_io_apdu_buffer, length);
+    lastResponse.length = length;
+    lastResponse.valid = true;
+}
+
+/**
+ * @brief Sets the result containing the next signatures of the batch.
+ *
+ * @details A single signature is sent back as is. When several signatures have been approved,
+ * the response starts with the number of signatures left to fetch with P1_NEXT_SIGNATURES
+ * and contains at most SIGNATURES_PER_RESPONSE signatures. For a sequence, each signature is
+ * followed by the transaction ID and a response contains at most SEQUENCE_RECORDS_PER_RESPONSE of them.
+ * The response is kept to be read again with INS_GET_LAST_RESPONSE.
+ *
+ * @return The total size of the data written to the APDU buffer.
+ */
+uint32_t set_result_signatures(void)
+{
+    uint32_t tx = 0;
+    uint8_t count = signatureBatch.count - signatureBatch.next;
+    uint8_t perResponse = signatureBatch.sequence ? SEQUENCE_RECORDS_PER_RESPONSE : SIGNATURES_PER_RESPONSE;
+
+    if (count > perResponse) {
+        count = perResponse;
+    }
+    if (signatureBatch.multiple) {
+        G_io_apdu_buffer[tx++] = signatureBatch.count - signatureBatch.next - count;
+    }
+    while (count--) {
+        if (signatureBatch.sequence) {
+            compute_tx_id(batch_hash(signatureBatch.next), G_io_apdu_buffer + tx + 65);
+            tx = append_signature(tx, signatureBatch.next++);
+            tx += 32;
+        } else {
+            tx = append_signature(tx, signatureBatch.next++);
+        }
+    }
+    last_response_store(tmpCtx.transactionContext.hash, tx);
+    if (signatureBatch.next == signatureBatch.count) {
+        memset(&signatureBatch, 0, sizeof(signatureBatch));
+    }
+    return tx;
+}
+/////////////////////////////////////////////////////////////////////
+
+
+/**
+ * @brief Exits the touch operation and returns to the dashboard.
+ *
+ * @details This function exits the touch operation and returns to the dashboard by invoking the operating system scheduler exit function.
+ * It follows these steps:
+ * - Calls the operating system scheduler exit function to return to the dashboard.
+ * - Returns 0 indicating that the widget should not be redrawn.
+ *
+ * @return 0 indicating that the widget should not be redrawn.
+ */
+unsigned int io_seproxyhal_touch_exit() {
+    speculative_sign_wipe();
+    last_response_wipe();
+    // Go back to the dashboard
+    os_sched_exit(0);
     return 0; // do not redraw the widget
 }
 
@@ -782,7 +1624,15 @@ unsigned int io_seproxyhal_touch_exit() {
  */
 unsigned int io_seproxyhal_touch_cancel() {
     uint32_t tx = 0;
+    // Never keep a signature for a rejected request
+    speculative_sign_wipe();
+    // The review of an address leaves the signing session untouched
+    if (signatureBatch.count != 0) {
+        memset(&signatureBatch, 0, sizeof(signatureBatch));
+        sign_session_end();
+    }
     apdu_buffer_append_state(&tx, HW_SW_TRANSACTION_CANCELLED);
+    stats_apdu_reply(HW_SW_TRANSACTION_CANCELLED, tx);
     // Send back the response, do not restart the event loop
     io_exchange(CHANNEL_APDU | IO_RETURN_AFTER_TX, 2);
 #ifdef HAVE_BAGL
@@ -810,7 +1660,40 @@ unsigned int io_seproxyhal_touch_address_ok() {
 
     // Add success status code
     apdu_buffer_append_state(&tx, HW_OK);
+    stats_apdu_reply(HW_OK, tx);
+
+    // Send back the response, do not restart the event loop
+    io_exchange(CHANNEL_APDU | IO_RETURN_AFTER_TX, tx);
+
+#ifdef HAVE_BAGL
+    // Display back the original UX
+    ui_idle();
+#endif
+    return 0; // do not redraw the widget
+}
+
+/**
+ * @brief Handles the confirmation of a change of the address book.
+ *
+ * @details This function writes the reviewed entry to NVM, or removes it, and sends back
+ * the status of the change. The book cannot have been filled since the request was checked,
+ * other instructions never writing it.
+ *
+ * @return 0 indicating that the widget should not be redrawn.
+ */
+unsigned int io_seproxyhal_touch_address_book_ok() {
+    uint32_t tx = 0;
+    unsigned short sw = HW_OK;
 
+    if (addressBookContext.remove) {
+        if (!address_book_remove(addressBookContext.address)) {
+            sw = HW_REFERENCED_DATA_NOT_FOUND;
+        }
+    } else if (!address_book_add(addressBookContext.address, addressBookContext.label)) {
+        sw = HW_NOT_ENOUGH_MEMORY_SPACE;
+    }
+    apdu_buffer_append_state(&tx, sw);
+    stats_apdu_reply(sw, tx);
     // Send back the response, do not restart the event loop
     io_exchange(CHANNEL_APDU | IO_RETURN_AFTER_TX, tx);
 
@@ -826,9 +1709,8 @@ unsigned int io_seproxyhal_touch_address_ok() {
  *
  * @details This function confirms a transaction by signing the message with the provided parameters,
  * and sends back the response containing the signature and transaction status. It follows these steps:
- * - Initializes variables for signature components and transaction status.
- * - Performs a heartbeat to ensure proper device operation.
- * - Calls the crypto_sign_message function to sign the message.
+ * - Calls the set_result_signatures function to sign the message with the first paths of the batch,
+ *   using the speculative signature if it has been computed during the review.
  * - Moves the signature components and transaction status to the APDU buffer.
  * - Sends back the response and does not restart the event loop.
  * - Optionally displays back the original UX if BAGL is supported.
@@ -836,34 +1718,13 @@ unsigned int io_seproxyhal_touch_address_ok() {
  * @return 0 indicating that the widget should not be redrawn.
  */
 unsigned int io_seproxyhal_touch_tx_ok() {
-    uint32_t tx = 0;
-    uint8_t sig_r[32];
-    uint8_t sig_s[32];
-    uint8_t v = 0;
-    int error;
-
-    io_seproxyhal_io_heartbeat();
-    // Sign the message
-    error = crypto_sign_message(sig_r, sig_s, &v);
-    io_seproxyhal_io_heartbeat();
-
-    if (error != 0) {
-        THROW(error);
-    }
-
-    // Move signature components to the APDU buffer
-    memmove(G_io_apdu_buffer, sig_r, 32);
-    memmove(G_io_apdu_buffer + 32, sig_s, 32);
-    tx = 64;
-    G_io_apdu_buffer[tx++] = v & 0x01;
-
-    // Clear the signature components from memory after use.
-    memset(sig_r, 0, 32);
-    memset(sig_s, 0, 32);
-    v = 0;
+    // Sign and move the first signatures of the batch to the APDU buffer
+    uint32_t tx = set_result_signatures();
+    sign_session_end();
 
     // Add success status code
     apdu_buffer_append_state(&tx, HW_OK);
+    stats_apdu_reply(HW_OK, tx);
     // Send back the response, do not restart the event loop
     io_exchange(CHANNEL_APDU | IO_RETURN_AFTER_TX, tx);
 
@@ -928,15 +1789,15 @@ uint32_t set_result_get_publicKey() {
     uint32_t tx = 0;
     // Set size of the public key, copy the public key into the APDU buffer, and update the buffer size counter
     G_io_apdu_buffer[tx++] = 65;
-    memmove(G_io_apdu_buffer + tx, tmpCtx.publicKeyContext.publicKey.W, 65);
+    memmove(G_io_apdu_buffer + tx, publicKeyContext.publicKey.W, 65);
     tx += 65;
     // Set size of the address, copy the address into the APDU buffer, and update the buffer size counter
     G_io_apdu_buffer[tx++] = 40;
-    memmove(G_io_apdu_buffer + tx, tmpCtx.publicKeyContext.address, 40);
+    memmove(G_io_apdu_buffer + tx, publicKeyContext.address, 40);
     tx += 40;
     // if chaincode is available, copy the chaincode into the APDU buffer and update the buffer size counter
-    if (tmpCtx.publicKeyContext.getChaincode) {
-        memmove(G_io_apdu_buffer + tx, tmpCtx.publicKeyContext.chainCode,
+    if (publicKeyContext.getChaincode) {
+        memmove(G_io_apdu_buffer + tx, publicKeyContext.chainCode,
                    32);
         tx += 32;
     }
@@ -985,25 +1846,25 @@ void handleGetPublicKey(uint8_t p1, uint8_t p2, uint8_t dataBuffer[static 255],
     parseBip32Path(&dataBuffer, &dataLength, &bip32PathLength, bip32Path);
 
     // Determine whether to include chaincode in the derived private key
-    tmpCtx.publicKeyContext.getChaincode = (p2 == P2_CHAINCODE);
+    publicKeyContext.getChaincode = (p2 == P2_CHAINCODE);
 
     // Derive private key using the provided BIP32 path
     crypto_derive_private_key(&privateKey,
-                              (tmpCtx.publicKeyContext.getChaincode ? tmpCtx.publicKeyContext.chainCode : NULL),
+                              (publicKeyContext.getChaincode ? publicKeyContext.chainCode : NULL),
                                bip32Path,
                                bip32PathLength);
 
     // Initialize public key based on the derived private key
     crypto_init_public_key(&privateKey,
-                           &tmpCtx.publicKeyContext.publicKey,
+                           &publicKeyContext.publicKey,
                            rawPublicKey);
 
     // reset private key
     explicit_bzero(&privateKey, sizeof(privateKey));
 
     // Construct VeChain address from the derived public key
-    getVetAddressStringFromKey(&tmpCtx.publicKeyContext.publicKey,
-                               tmpCtx.publicKeyContext.address);
+    getVetAddressStringFromKey(&publicKeyContext.publicKey,
+                               publicKeyContext.address);
 
     // Handle different modes of operation (confirm/non-confirm)
     if (p1 == P1_NON_CONFIRM) {
@@ -1018,7 +1879,7 @@ void handleGetPublicKey(uint8_t p1, uint8_t p2, uint8_t dataBuffer[static 255],
 
         // Format the address for display
         snprintf((char *)fullAddress, sizeof(fullAddress), "0x%.*s", 40,
-            tmpCtx.publicKeyContext.address);
+            publicKeyContext.address);
 
 #ifdef HAVE_BAGL
 
@@ -1041,173 +1902,1329 @@ void handleGetPublicKey(uint8_t p1, uint8_t p2, uint8_t dataBuffer[static 255],
 }
 
 /**
- * @brief Handles the signing of a transaction.
+ * @brief Reviews a parsed transaction as its VIP-191 gas payer.
  *
- * @details This function handles the signing of a transaction. It supports both the first
- * part of the transaction and subsequent parts. It follows these steps:
- * - Parses the input parameters to determine the action to be taken.
- * - Initializes the transaction context and prepares for transaction processing.
- * - Processes the transaction data, including path extraction, clause content, and data presence.
- * - Stores the transaction hash and performs necessary checks.
- * - Prepares the display or UI for confirming the transaction signing action.
+ * @details The gas payer does not authorize the clauses of the transaction, only the fee.
+ * It follows these steps:
+ * - Checks that the transaction enables the fee delegation feature.
+ * - Replaces the signing hash by the delegator hash, blake2b(signingHash || origin).
+ * - Prepares the display of the sender and of the maximum fee.
  *
- * @param[in] p1 Instruction parameter 1 (P1), indicating the type of transaction signing action.
- *        If set to P1_FIRST, it indicates the beginning of a new signing operation.
- *        If set to P1_MORE, it indicates further parts of the signing operation.
- * @param[in] p2 Instruction parameter 2 (P2), currently unused.
- * @param[in] workBuffer Pointer to the data buffer containing the transaction data.
- * @param[in] dataLength Length of the transaction data.
  * @param[in,out] flags Pointer to flags for APDU processing.
- * @param[in,out] tx Pointer to the outgoing APDU buffer size.
  */
-void handleSign(uint8_t p1, uint8_t p2, uint8_t workBuffer[static 255],
-                uint16_t dataLength, volatile unsigned int flags[static 1],
-                volatile unsigned int tx[static 1])
+static void handleSignDelegation(volatile unsigned int flags[static 1])
 {
-    UNUSED(tx);
-    parserStatus_e txResult;
-    //uint256_t gasPriceCoef, gas, baseGasPrice, maxGasCoef, uint256a, uint256b;
-    uint32_t i;
-    //uint8_t address[41];
-    uint8_t decimals = DECIMALS_VET;
-    uint8_t *ticker = (uint8_t *)TICKER_VET;
-
-    if (p1 == P1_FIRST) {
-        memset(&clausesContent, 0, sizeof(clausesContent));
-        memset(&clauseContent, 0, sizeof(clauseContent));
-        
-        // Extract and parse the BIP32 path
-        parseBip32Path(&workBuffer, &dataLength, &tmpCtx.transactionContext.pathLength, tmpCtx.transactionContext.bip32Path);
-        dataPresent = false;
-        initTx(&displayContext.txFullContext.txContext, &tmpContent.txContent,
-               &displayContext.txFullContext.clausesContext, &clausesContent,
-               &displayContext.txFullContext.clauseContext, &clauseContent,
-               &blake2b, NULL);
-    } else if (p1 != P1_MORE) {
-        THROW(HW_INCORRECT_P1_P2);
-    }
-    if (p2 != 0) {
-        THROW(HW_INCORRECT_P1_P2);
-    }
-    if (displayContext.txFullContext.txContext.currentField == TX_RLP_NONE) {
-        PRINTF("Parser not initialized\n");
-        THROW(HW_SW_TRANSACTION_CANCELLED);
-    }
-    if (displayContext.txFullContext.clausesContext.currentField == CLAUSES_RLP_NONE) {
-        PRINTF("Parser not initialized\n");
-        THROW(HW_SW_TRANSACTION_CANCELLED);
-    }
-    txResult = processTx(&displayContext.txFullContext.txContext,
-                         &displayContext.txFullContext.clausesContext,
-                         &displayContext.txFullContext.clauseContext,
-                         workBuffer,
-                         dataLength);
-    PRINTF("txResult:%d\n", txResult);
-    switch (txResult) {
-    case USTREAM_FINISHED:
-        break;
-    case USTREAM_PROCESSING:
-        THROW(HW_OK);
-    case USTREAM_FAULT:
-        THROW(HW_INCORRECT_DATA);
-    default:
-        PRINTF("Unexpected parser status\n");
+    if (!(tmpContent.txContent.features & TX_FEATURE_DELEGATION)) {
+        PRINTF("Fee delegation not enabled\n");
         THROW(HW_INCORRECT_DATA);
     }
 
-    // Store the hash
-    CX_ASSERT(cx_hash_no_throw((cx_hash_t *)&blake2b, CX_LAST, NULL, 0, tmpCtx.transactionContext.hash, 32));
+    // Delegator hash
+    CX_ASSERT(cx_blake2b_init_no_throw(&blake2b, 256));
+    CX_ASSERT(cx_hash_no_throw((cx_hash_t *)&blake2b, 0, tmpCtx.transactionContext.hash, 32, NULL, 0));
+    CX_ASSERT(cx_hash_no_throw((cx_hash_t *)&blake2b, CX_LAST, tmpCtx.transactionContext.origin,
+                               sizeof(tmpCtx.transactionContext.origin), tmpCtx.transactionContext.hash, 32));
 
-    PRINTF("messageHash:\n%.*H\n", 32, tmpCtx.transactionContext.hash);
-    // Check for data presence
-    dataPresent = clausesContent.dataPresent;
-    if (dataPresent && !N_storage.dataAllowed) {
-        PRINTF("Data field forbidden\n");
-        THROW(HW_INCORRECT_DATA);
-    }
+    // Add sender address, the maximum fee is computed when displayed
+    addressToDisplayString(tmpCtx.transactionContext.origin, (uint8_t *)fullAddress);
+    review_values_reset(REVIEW_VALUE_BIT(REVIEW_VALUE_ADDRESS));
 
-    // Check for multiple clauses
-    multipleClauses = (clausesContent.clausesLength > 1);
-    if (multipleClauses && !N_storage.multiClauseAllowed) {
-        PRINTF("Multiple clauses forbidden\n");
-        THROW(HW_INCORRECT_DATA);
-    }
+    multipleSigners = false;
+    signature_batch_init(1, false);
 
-    // If there is a token to process, check if it is well known
-    if (dataPresent && memcmp(clauseContent.data, TOKEN_TRANSFER_ID, 4) == 0) {
-        for (i = 0; i < NUM_TOKENS; i++) {
-            tokenDefinition_t *currentToken = PIC(&TOKENS[i]);
-            if (memcmp(currentToken->address,
-                          clauseContent.to, 20) == 0) {
-                dataPresent = false;
-                decimals = currentToken->decimals;
-                ticker = currentToken->ticker;
-                clauseContent.toLength = 20;
-                memmove(clauseContent.to,
-                           clauseContent.data + 4 + 12, 20);
-                memmove(clauseContent.value.value,
-                           clauseContent.data + 4 + 32, 32);
-                clauseContent.value.length = 32;
-                break;
-            }
-        }
+    // Start signing in the background while the user reviews the fee
+    speculative_sign_schedule();
+
+#ifdef HAVE_BAGL
+    if(G_ux.stack_count == 0) {
+    ux_stack_push();
     }
+    ux_flow_init(0, ux_confirm_delegation_flow, NULL);
+#else
+    ui_display_action_sign_delegation_flow();
+#endif
 
-    // Add address
-    addressToDisplayString(clauseContent.to, (uint8_t *)fullAddress);
+    *flags |= IO_ASYNCH_REPLY;
+}
 
-    // Add amount in ethers or tokens
-    sendAmountToDisplayString(
-        &clauseContent.value,
-        ticker,
-        decimals,
-        (uint8_t *)fullAmount);
+/**
+ * @brief Handles a transaction of a sequence chained by dependsOn once it has been hashed.
+ *
+ * @details The clauses of each transaction have been checked against the settings and totaled
+ * while parsed, and its maximum fee is added to the total of the sequence. Until the last
+ * transaction, the ID of the transaction is sent back and substituted to the dependsOn placeholder
+ * of the next one. After the last one, the user reviews the recipients, the totals per asset and
+ * the fees of the whole sequence, and one signature per transaction is returned with its ID.
+ *
+ * @param[in,out] flags Pointer to flags for APDU processing.
+ * @param[in,out] tx Pointer to the outgoing APDU buffer size.
+ */
+static void handleSignSequence(volatile unsigned int flags[static 1], volatile unsigned int tx[static 1])
+{
+    uint8_t index = tmpCtx.transactionContext.sequenceIndex;
+    uint256_t total;
 
-    // Compute maximum fee
+    // The clauses have been checked against the settings while parsed
+    // Add the maximum fee of this transaction to the total
     maxFeeToDisplayString(
         &tmpContent.txContent.gaspricecoef,
         &tmpContent.txContent.gas,
         &displayContext.feeComputationContext,
         (uint8_t *)maxFee);
+    add256(&tmpCtx.transactionContext.sequenceFee, &displayContext.feeComputationContext.maxFee, &total);
+    copy256(&tmpCtx.transactionContext.sequenceFee, &total);
+
+    tmpCtx.transactionContext.sequenceIndex = ++index;
+    if (index < tmpCtx.transactionContext.sequenceLength) {
+        // The ID of this transaction is the dependsOn of the next one
+        compute_tx_id(batch_hash(index - 1), tmpCtx.transactionContext.dependsOn);
+        memmove(G_io_apdu_buffer, tmpCtx.transactionContext.dependsOn, 32);
+        *tx = 32;
+        // The next transaction must start with P1_NEXT_TRANSACTION
+        memset(&displayContext, 0, sizeof(displayContext));
+        THROW(HW_OK);
+    }
+
+    // Review the whole sequence: its recipients, the totals per asset and the fees
+    snprintf((char *)reviewSubtitle, sizeof(reviewSubtitle), "%d transactions", index);
+    snprintf((char *)fullAmount, sizeof(fullAmount), "%d", index);
+    addressToDisplayString(tmpCtx.transactionContext.signer, (uint8_t *)fullAddress);
+    amountToDisplayString(&tmpCtx.transactionContext.sequenceFee, TICKER_VTHO, DECIMALS_VTHO, (uint8_t *)maxFee);
+    review_values_reset(REVIEW_VALUES_ALL);
+
+    multipleSigners = false;
+    signature_batch_init(index, true);
+    signatureBatch.sequence = true;
+
+    // Start signing the first transaction in the background while the user reviews the sequence
+    speculative_sign_schedule();
 
 #ifdef HAVE_BAGL
     if(G_ux.stack_count == 0) {
     ux_stack_push();
     }
-    if(dataPresent && multipleClauses){
-        ux_flow_init(0, ux_confirm_full_data_clauses_flow, NULL);
-    }
-    else if(dataPresent && !multipleClauses){
-        ux_flow_init(0, ux_confirm_full_data_flow, NULL);
-    }
-    else if(!dataPresent && multipleClauses){
-        ux_flow_init(0, ux_confirm_full_clauses_flow, NULL);
-    }
-    else{
-        ux_flow_init(0, ux_confirm_full_flow, NULL);
-    }
+    clause_review_totals();
+    clauseReview.sequence = true;
+    clauseReview.inside = false;
+    ux_flow_init(0, dataPresent ? ux_confirm_data_sequence_flow : ux_confirm_sequence_flow, NULL);
 #else
-    ui_display_action_sign_tx_flow();
+    ui_display_action_sign_sequence_flow();
 #endif
 
     *flags |= IO_ASYNCH_REPLY;
 }
 
 /**
- * @brief Retrieves the application configuration settings and version information.
- *
- * @details This function retrieves the application configuration settings and version information
- * for the current application. It follows these steps:
- * - Retrieves the application configuration settings from non-volatile storage.
- * - Retrieves the major, minor, and patch version numbers of the application.
- * - Sets the outgoing APDU buffer with the configuration settings and version information.
- * - Sets the outgoing APDU buffer size to indicate the number of bytes transmitted.
- *
- * @note Settings values:
- * - 0: Both data and multiple clauses disabled.
- * - 1: Data enabled, multiple clauses disabled.
- * - 2: Data disabled, multiple clauses enabled.
+ * @brief Derives the address of the signer of a sequence.
+ */
+static void deriveSequenceSigner(void)
+{
+    cx_ecfp_private_key_t privateKey;
+    cx_ecfp_public_key_t publicKey;
+    uint8_t rawPublicKey[64];
+    int error;
+
+    error = crypto_derive_private_key(&privateKey, NULL,
+                                      tmpCtx.transactionContext.bip32Path,
+                                      tmpCtx.transactionContext.pathLength);
+    if (error == 0) {
+        error = crypto_init_public_key(&privateKey, &publicKey, rawPublicKey);
+    }
+    explicit_bzero(&privateKey, sizeof(privateKey));
+    if (error != 0) {
+        THROW(error);
+    }
+    getVetAddressFromKey(&publicKey, tmpCtx.transactionContext.signer);
+}
+
+/**
+ * @brief Looks for the well known token transferred by a clause.
+ *
+ * @details The tokens compiled in the application are looked for first, then the tokens
+ * provided with PROVIDE_TOKEN_INFO.
+ *
+ * @param[in] content Fields of the clause.
+ *
+ * @return The token definition, or NULL if the clause is not the transfer of a well known token.
+ */
+static const tokenDefinition_t *clause_token(const clauseContent_t *content)
+{
+    const tokenDefinition_t *token;
+
+    if ((content->data.length != TOKEN_TRANSFER_LENGTH) || memcmp(content->data.window, TOKEN_TRANSFER_ID, 4) != 0) {
+        return NULL;
+    }
+    token = token_lookup(content->to);
+    if (token != NULL) {
+        return token;
+    }
+    return token_cache_lookup(content->to);
+}
+
+/**
+ * @brief Gets the recipient of a clause, the token recipient for a token transfer.
+ *
+ * @param[in] content Fields of the clause.
+ * @param[in] token Token transferred by the clause, or NULL.
+ *
+ * @return The 20 bytes of the recipient.
+ */
+static const uint8_t *clause_recipient(const clauseContent_t *content, const tokenDefinition_t *token)
+{
+    return (token != NULL ? content->data.window + 4 + 12 : content->to);
+}
+
+/**
+ * @brief Formats a recipient for the review.
+ *
+ * @details A recipient of the address book is displayed as its label, followed by the
+ * ends of its address.
+ *
+ * @param[in] recipient Address of the recipient.
+ * @param[out] address Recipient, at least 43 bytes.
+ */
+static void recipient_format(const uint8_t *recipient, char *address)
+{
+    const char *label = address_book_lookup(recipient);
+    char checksumAddress[43];
+
+    if (label == NULL) {
+        addressToDisplayString((uint8_t *)recipient, (uint8_t *)address);
+        return;
+    }
+    addressToDisplayString((uint8_t *)recipient, (uint8_t *)checksumAddress);
+    snprintf(address, sizeof(checksumAddress), "%s (%.6s...%.4s)", label, checksumAddress,
+             checksumAddress + 38);
+}
+
+/**
+ * @brief Formats the recipient of a clause, the token recipient for a token transfer.
+ *
+ * @param[in] content Fields of the clause.
+ * @param[in] token Token transferred by the clause, or NULL.
+ * @param[out] address Recipient, at least 43 bytes.
+ */
+static void clause_address_format(clauseContent_t *content, const tokenDefinition_t *token, char *address)
+{
+    recipient_format(clause_recipient(content, token), address);
+}
+
+/**
+ * @brief Formats the amount of a clause, in VET or in the transferred token.
+ *
+ * @param[in] content Fields of the clause.
+ * @param[in] token Token transferred by the clause, or NULL.
+ * @param[out] amount Amount with its ticker, at least 50 bytes.
+ */
+static void clause_amount_format(clauseContent_t *content, const tokenDefinition_t *token, char *amount)
+{
+    txInt256_t tokenValue;
+
+    PROFILE_BEGIN(PROFILE_FORMAT_AMOUNT);
+    if (token != NULL) {
+        memmove(tokenValue.value, content->data.window + 4 + 32, 32);
+        tokenValue.length = 32;
+        sendAmountToDisplayString(&tokenValue, token->ticker, token->decimals, (uint8_t *)amount);
+    } else {
+        sendAmountToDisplayString(&content->value, TICKER_VET, DECIMALS_VET, (uint8_t *)amount);
+    }
+    PROFILE_END(PROFILE_FORMAT_AMOUNT);
+}
+
+/**
+ * @brief Formats the recipient and the amount of a clause for the review.
+ *
+ * @details The transfer of a well known token is displayed as the transfer of the token
+ * amount to the token recipient, instead of a call of the token contract.
+ *
+ * @param[in] content Fields of the clause.
+ * @param[out] address Recipient, at least 43 bytes.
+ * @param[out] amount Amount with its ticker, at least 50 bytes.
+ *
+ * @return True if the clause is the transfer of a well known token.
+ */
+static bool clause_format(clauseContent_t *content, char *address, char *amount)
+{
+    const tokenDefinition_t *token = clause_token(content);
+
+    clause_address_format(content, token, address);
+    clause_amount_format(content, token, amount);
+    return token != NULL;
+}
+
+/**
+ * @brief Sets the subtitle of the review, mentioning the number of accounts signing.
+ */
+static void review_subtitle_set(void)
+{
+    // One signature per path, the review mentions the number of accounts
+    multipleSigners = (tmpCtx.transactionContext.extraPathCount != 0);
+    if (multipleSigners) {
+        snprintf((char *)reviewSubtitle, sizeof(reviewSubtitle), "for %d accounts",
+                 tmpCtx.transactionContext.extraPathCount + 1);
+    } else {
+        snprintf((char *)reviewSubtitle, sizeof(reviewSubtitle), "transaction");
+    }
+}
+
+#ifdef HAVE_NBGL
+/**
+ * @brief Sets the warnings of a transaction reviewed while it is streamed, from the clauses parsed so far.
+ *
+ * @details More clauses follow a completed first clause as long as the parser is in the list of clauses.
+ */
+static void stream_review_warning_set(void)
+{
+    dataPresent = clausesContent.dataPresent;
+    multipleClauses = (clausesContent.clausesLength > 1) ||
+                      (!displayContext.txFullContext.clausesContext.processingField &&
+                       (displayContext.txFullContext.txContext.currentField == TX_RLP_CLAUSES));
+}
+#endif
+
+/**
+ * @brief Clears the totals per asset, before the first clause of a transaction.
+ */
+static void asset_totals_reset(void)
+{
+    memset(&assetTotals, 0, sizeof(assetTotals));
+    // VET is always totaled, first
+    assetTotals.count = 1;
+}
+
+/**
+ * @brief Adds an amount sent by a clause to the total of its asset.
+ *
+ * @details A total which would not fit in 256 bits rejects the transaction, as it would be
+ * displayed lower than the amounts sent. Past REVIEW_TOTALS_MAX assets, the other tokens
+ * are not totaled and the review says so.
+ *
+ * @param[in] token Token sent, NULL for VET.
+ * @param[in] amount Amount sent, big endian.
+ * @param[in] length Length of the amount, up to 32 bytes.
+ */
+static void asset_total_add(const tokenDefinition_t *token, const uint8_t *amount, uint32_t length)
+{
+    uint256_t value;
+    uint256_t total;
+    uint8_t i;
+
+    convertUint256BE(amount, length, &value);
+    if (zero256(&value)) {
+        return;
+    }
+    for (i = 0; i < assetTotals.count; i++) {
+        if (assetTotals.assets[i].token == token) {
+            break;
+        }
+    }
+    if (i == assetTotals.count) {
+        if (i == REVIEW_TOTALS_MAX) {
+            assetTotals.partial = true;
+            return;
+        }
+        assetTotals.assets[i].token = token;
+        assetTotals.count++;
+    }
+    add256(&assetTotals.assets[i].amount, &value, &total);
+    if (gt256(&assetTotals.assets[i].amount, &total)) {
+        PRINTF("Total overflow\n");
+        THROW(HW_INCORRECT_DATA);
+    }
+    copy256(&assetTotals.assets[i].amount, &total);
+}
+
+/**
+ * @brief Checks a parsed clause against the settings and adds its amounts to the totals per asset.
+ *
+ * @details The data and multiple clauses settings are checked as soon as the clause is parsed,
+ * so that a forbidden transaction is rejected before the user starts reviewing it.
+ *
+ * @param[in] index Index of the clause in the transaction.
+ * @param[in] content Fields of the clause.
+ * @param[in] clauseData True if the clause carries data.
+ *
+ * @return The token transferred by the clause, or NULL.
+ */
+static const tokenDefinition_t *review_clause_check(uint16_t index, clauseContent_t *content, bool clauseData)
+{
+    const tokenDefinition_t *token = clause_token(content);
+
+    if (clauseData && !N_storage.dataAllowed) {
+        PRINTF("Data field forbidden\n");
+        THROW(HW_INCORRECT_DATA);
+    }
+    if ((index != 0) && !N_storage.multiClauseAllowed) {
+        PRINTF("Multiple clauses forbidden\n");
+        THROW(HW_INCORRECT_DATA);
+    }
+
+    // A token transfer may send VET as well
+    asset_total_add(NULL, content->value.value, content->value.length);
+    if (token != NULL) {
+        asset_total_add(token, content->data.window + 4 + 32, 32);
+    }
+    return token;
+}
+
+/**
+ * @brief Clause completion hook of the parser, for the review of each clause.
+ *
+ * @details The amounts sent are added to the totals per asset, reviewed after the clauses.
+ * On NBGL devices the clause is added to the streamed review, the parser being suspended once
+ * its queue is full. On BAGL devices it is kept for the clause review steps, formatted when
+ * they are displayed.
+ *
+ * @param[in] index Index of the clause in the transaction.
+ * @param[in] content Fields of the clause.
+ * @param[in] clauseData True if the clause carries data.
+ */
+static void review_clause_done(uint16_t index, clauseContent_t *content, bool clauseData)
+{
+    const tokenDefinition_t *token = review_clause_check(index, content, clauseData);
+#ifdef HAVE_NBGL
+    char address[43];
+    char amount[50];
+#endif
+
+#ifdef HAVE_NBGL
+    clause_format(content, address, amount);
+    ui_stream_review_clause(index, address, amount, (clauseData && (token == NULL)) ? &content->data : NULL);
+    if (ui_stream_review_full()) {
+        // No more clause is parsed until the user has reviewed one of the queued clauses
+        displayContext.txFullContext.clausesContext.suspendAfterClause = true;
+    }
+#else
+    clauseReview.index = index;
+    clauseReview.content = content;
+    clauseReview.field = 0;
+    clauseReview.fieldCount = CLAUSE_FIELD_DATA;
+    if (clauseData && (token == NULL)) {
+        // The data is displayed page by page in expert mode
+        clauseReview.fieldCount += N_storage.expertMode ? calldata_page_count(&content->data) : 1;
+    }
+#endif
+}
+
+/**
+ * @brief Clause completion hook of the parser, for the review of a sequence of transactions.
+ *
+ * @details The clauses of every transaction of the sequence are checked and totaled as the ones
+ * of a single transaction. Their distinct recipients are kept, all of them being reviewed along
+ * with the totals before the approval: a sequence with more than SEQUENCE_RECIPIENTS_MAX
+ * recipients is rejected.
+ *
+ * @param[in] index Index of the clause in its transaction.
+ * @param[in] content Fields of the clause.
+ * @param[in] clauseData True if the clause carries data.
+ */
+static void sequence_clause_done(uint16_t index, clauseContent_t *content, bool clauseData)
+{
+    const tokenDefinition_t *token = review_clause_check(index, content, clauseData);
+    const uint8_t *recipient = clause_recipient(content, token);
+    uint8_t i;
+
+    if (clauseData && (token == NULL)) {
+        dataPresent = true;
+    }
+    for (i = 0; i < tmpCtx.transactionContext.recipientCount; i++) {
+        if (memcmp(tmpCtx.transactionContext.recipients[i], recipient, 20) == 0) {
+            return;
+        }
+    }
+    if (i == SEQUENCE_RECIPIENTS_MAX) {
+        PRINTF("Too many recipients\n");
+        THROW(HW_INCORRECT_DATA);
+    }
+    memmove(tmpCtx.transactionContext.recipients[i], recipient, 20);
+    tmpCtx.transactionContext.recipientCount++;
+}
+
+/**
+ * @brief Gets the number of recipients to review.
+ *
+ * @return The number of distinct recipients of a sequence, none for a single transaction.
+ */
+uint8_t review_recipients_count(void)
+{
+    if (tmpCtx.transactionContext.signMode != P2_SIGN_SEQUENCE) {
+        return 0;
+    }
+    return tmpCtx.transactionContext.recipientCount;
+}
+
+/**
+ * @brief Formats a recipient of a sequence for the review.
+ *
+ * @param[in] index Index of the recipient, below review_recipients_count().
+ * @param[out] out Recipient, at least 43 bytes.
+ */
+void review_recipient_format(uint8_t index, char *out)
+{
+    recipient_format(tmpCtx.transactionContext.recipients[index], out);
+}
+
+/**
+ * @brief Gets the number of totals per asset to review.
+ *
+ * @return The number of totals, VET being the first one, plus one when some tokens are not totaled.
+ * None for a transaction with a single clause, a sequence always showing its totals.
+ */
+uint8_t review_totals_count(void)
+{
+    if ((clausesContent.clausesLength <= 1) && (tmpCtx.transactionContext.signMode != P2_SIGN_SEQUENCE)) {
+        return 0;
+    }
+    return assetTotals.count + (assetTotals.partial ? 1 : 0);
+}
+
+/**
+ * @brief Formats a total per asset for the review.
+ *
+ * @param[in] index Index of the total, below review_totals_count().
+ * @param[out] out Total with its ticker, at least 50 bytes.
+ */
+void review_total_format(uint8_t index, char *out)
+{
+    const assetTotal_t *asset = &assetTotals.assets[index];
+
+    if (index >= assetTotals.count) {
+        snprintf(out, 50, "Other tokens, see clauses");
+    } else if (asset->token == NULL) {
+        amountToDisplayString((uint256_t *)&asset->amount, TICKER_VET, DECIMALS_VET, (uint8_t *)out);
+    } else {
+        amountToDisplayString((uint256_t *)&asset->amount, asset->token->ticker, asset->token->decimals,
+                              (uint8_t *)out);
+    }
+}
+
+/**
+ * @brief Gets the number of 32 bytes words following the selector of some data.
+ *
+ * @param[in] length Length of the data.
+ *
+ * @return The number of words, the last one being possibly shorter.
+ */
+static uint32_t calldata_word_count(uint32_t length)
+{
+    return (length <= 4) ? 0 : (length - 4 + 31) / 32;
+}
+
+/**
+ * @brief Gets the number of pages of the expert review of the data of a clause.
+ *
+ * @param[in] data Data of the clause.
+ *
+ * @return The number of pages, at most CALLDATA_PAGES_MAX.
+ */
+uint8_t calldata_page_count(const clauseData_t *data)
+{
+    uint32_t kept = (data->length < CLAUSE_DATA_WINDOW) ? data->length : CLAUSE_DATA_WINDOW;
+
+    // Selector, length, the words kept, hash
+    return 2 + calldata_word_count(kept) + 1;
+}
+
+/**
+ * @brief Formats a page of the expert review of the data of a clause.
+ *
+ * @details The selector and the words kept while parsing are displayed in hex, the hash
+ * covering the whole data, including the words which have not been kept.
+ *
+ * @param[in] data Data of the clause.
+ * @param[in] page Index of the page, below calldata_page_count().
+ * @param[out] title Title of the page.
+ * @param[in] titleSize Size of the title buffer.
+ * @param[out] text Value of the page, at least CALLDATA_TEXT_LENGTH bytes.
+ */
+void calldata_page_format(const clauseData_t *data, uint8_t page, char *title, size_t titleSize, char *text)
+{
+    uint8_t words = calldata_page_count(data) - 3;
+    uint32_t offset;
+    uint32_t length;
+
+    if (page == 0) {
+        snprintf(title, titleSize, "Selector");
+        text[0] = '0';
+        text[1] = 'x';
+        array_hexstr(text + 2, data->window, (data->length < 4) ? data->length : 4);
+    } else if (page == 1) {
+        snprintf(title, titleSize, "Data length");
+        snprintf(text, CALLDATA_TEXT_LENGTH, "%u bytes", (unsigned int)data->length);
+    } else if (page < 2 + words) {
+        offset = 4 + (page - 2) * 32;
+        length = (data->length - offset < 32) ? data->length - offset : 32;
+        snprintf(title, titleSize, "Word %d/%u", page - 1, (unsigned int)calldata_word_count(data->length));
+        array_hexstr(text, data->window + offset, length);
+    } else {
+        snprintf(title, titleSize, "Data hash");
+        array_hexstr(text, data->hash, sizeof(data->hash));
+    }
+}
+
+/**
+ * @brief Gets the data of the transaction reviewed at once, for the expert review.
+ *
+ * @return The data of the first clause, or NULL when the expert mode is disabled, the clause
+ * has no data or its data is a well known token transfer.
+ */
+const clauseData_t *review_calldata(void)
+{
+    if (!N_storage.expertMode || !clauseContent.dataPresent || (clause_token(&clauseContent) != NULL)) {
+        return NULL;
+    }
+    return &clauseContent.data;
+}
+
+/**
+ * @brief Sends the status word of a data block once its processing has been delayed.
+ *
+ * @param[in] sw Status word.
+ */
+static void io_seproxyhal_send_status(unsigned short sw)
+{
+    uint32_t tx = 0;
+
+    apdu_buffer_append_state(&tx, sw);
+    stats_apdu_reply(sw, tx);
+    // Send back the response, do not restart the event loop
+    io_exchange(CHANNEL_APDU | IO_RETURN_AFTER_TX, tx);
+}
+
+#ifdef HAVE_NBGL
+/**
+ * @brief Handles the rejection of a transaction during its streamed review.
+ *
+ * @details The signing session ends, so that the following data blocks of the transaction
+ * are answered with HW_SW_TRANSACTION_CANCELLED. When a reply is waiting for the user,
+ * it is sent with the same status.
+ *
+ * @param[in] replyPending True if the host waits for the reply of a data block.
+ *
+ * @return 0 indicating that the widget should not be redrawn.
+ */
+unsigned int io_seproxyhal_touch_stream_cancel(bool replyPending)
+{
+    sign_session_end();
+    if (replyPending) {
+        return io_seproxyhal_touch_cancel();
+    }
+    speculative_sign_wipe();
+    return 0; // do not redraw the widget
+}
+#endif
+
+/**
+ * @brief Forgets the review values formatted so far.
+ *
+ * @param[in] ready Values already formatted into their buffer by the caller, one bit per reviewValue_e.
+ */
+static void review_values_reset(uint8_t ready)
+{
+    reviewValuesReady = ready;
+}
+
+/**
+ * @brief Gets a value of the transaction review, formatting it on first use.
+ *
+ * @details The review screens call this when they are displayed, so that the address checksum,
+ * the amount and the fee computation are only done for the screens the user reaches.
+ * The value is kept in its display buffer until the next review.
+ *
+ * @param[in] value Value to get.
+ *
+ * @return The value, as displayed.
+ */
+const char *review_value(reviewValue_e value)
+{
+    bool ready = (reviewValuesReady & REVIEW_VALUE_BIT(value)) != 0;
+
+    reviewValuesReady |= REVIEW_VALUE_BIT(value);
+    switch (value) {
+    case REVIEW_VALUE_ADDRESS:
+        if (!ready) {
+            clause_address_format(&clauseContent, clause_token(&clauseContent), (char *)fullAddress);
+            TRACE(TRACE_FORMAT_DONE, value, 0);
+        }
+        return (const char *)fullAddress;
+    case REVIEW_VALUE_AMOUNT:
+        if (!ready) {
+            clause_amount_format(&clauseContent, clause_token(&clauseContent), (char *)fullAmount);
+            TRACE(TRACE_FORMAT_DONE, value, 0);
+        }
+        return (const char *)fullAmount;
+    default:
+        if (!ready) {
+            PROFILE_BEGIN(PROFILE_FORMAT_FEE);
+            maxFeeToDisplayString(
+                &tmpContent.txContent.gaspricecoef,
+                &tmpContent.txContent.gas,
+                &displayContext.feeComputationContext,
+                (uint8_t *)maxFee);
+            PROFILE_END(PROFILE_FORMAT_FEE);
+            TRACE(TRACE_FORMAT_DONE, value, 0);
+        }
+        return (const char *)maxFee;
+    }
+}
+
+/**
+ * @brief Parses a data block of the transaction being signed.
+ *
+ * @param[in] buffer Data of the block.
+ * @param[in] length Length of the data.
+ *
+ * @return The status of the parser.
+ */
+static parserStatus_e sign_tx_parse(uint8_t *buffer, uint32_t length)
+{
+    parserStatus_e txResult;
+
+    displayContext.txFullContext.clausesContext.suspended = false;
+    PROFILE_BEGIN(PROFILE_PARSE);
+    txResult = processTx(&displayContext.txFullContext.txContext,
+                         &displayContext.txFullContext.clausesContext,
+                         &displayContext.txFullContext.clauseContext,
+                         buffer,
+                         length);
+    PROFILE_END(PROFILE_PARSE);
+    TRACE(TRACE_TX_RESULT, txResult, 0);
+    return txResult;
+}
+
+/**
+ * @brief Checks the parsed transaction against the settings and formats it for the review.
+ *
+ * @details Also prepares the signatures of the transaction, computed in the background
+ * while the user reviews it.
+ */
+static void sign_tx_prepare_review(void)
+{
+    // Check for data presence
+    dataPresent = clausesContent.dataPresent;
+    if (dataPresent && !N_storage.dataAllowed) {
+        PRINTF("Data field forbidden\n");
+        THROW(HW_INCORRECT_DATA);
+    }
+
+    // Check for multiple clauses
+    multipleClauses = (clausesContent.clausesLength > 1);
+    if (multipleClauses && !N_storage.multiClauseAllowed) {
+        PRINTF("Multiple clauses forbidden\n");
+        THROW(HW_INCORRECT_DATA);
+    }
+
+    // A well known token transfer is not data, its amount and recipient are formatted when displayed
+    if (clause_token(&clauseContent) != NULL) {
+        dataPresent = false;
+    }
+    review_values_reset(0);
+
+    review_subtitle_set();
+    signature_batch_init(tmpCtx.transactionContext.extraPathCount + 1,
+                         tmpCtx.transactionContext.signMode == P2_SIGN_MULTI_PATH);
+
+    // Start signing in the background while the user reviews the transaction
+    speculative_sign_schedule();
+}
+
+#ifdef HAVE_NBGL
+/**
+ * @brief Parses the rest of a suspended data block, once the streamed review has room for more clauses.
+ *
+ * @details Called from the review screens: the reply of the data block is sent once it has been
+ * parsed, unless the queue of the review is full again. The reply of the last block waits for the
+ * approval. Errors are replied to the pending data block.
+ *
+ * @return 0 indicating that the widget should not be redrawn.
+ */
+unsigned int io_seproxyhal_touch_stream_continue(void)
+{
+    BEGIN_TRY {
+        TRY {
+            displayContext.txFullContext.clausesContext.suspendAfterClause = false;
+            // The end of the data block is still in the APDU buffer, not replied yet
+            switch (sign_tx_parse(displayContext.txFullContext.txContext.workBuffer,
+                                  displayContext.txFullContext.txContext.commandLength)) {
+            case USTREAM_SUSPENDED:
+                ui_stream_review_hold();
+                break;
+            case USTREAM_PROCESSING:
+                io_seproxyhal_send_status(HW_OK);
+                break;
+            case USTREAM_FINISHED:
+                CX_ASSERT(cx_hash_no_throw((cx_hash_t *)&blake2b, CX_LAST, NULL, 0, tmpCtx.transactionContext.hash, 32));
+                TRACE(TRACE_HASH_DONE, 0, (tmpCtx.transactionContext.hash[0] << 8) | tmpCtx.transactionContext.hash[1]);
+                sign_tx_prepare_review();
+                ui_stream_review_finish();
+                break;
+            default:
+                THROW(HW_INCORRECT_DATA);
+            }
+        }
+        CATCH(EXCEPTION_IO_RESET) {
+            THROW(EXCEPTION_IO_RESET);
+        }
+        CATCH_OTHER(e) {
+            // The transaction cannot be signed any more
+            sign_session_end();
+            io_seproxyhal_send_status(((e & ERROR_TYPE_MASK) == ERROR_TYPE_HW) ? e : (0x6800 | (e & 0x7FF)));
+            ui_stream_review_abort();
+        }
+        FINALLY {
+        }
+    }
+    END_TRY;
+    return 0; // do not redraw the widget
+}
+#endif
+
+#ifdef HAVE_BAGL
+/**
+ * @brief Formats the field of the clause on screen into the shared display buffer.
+ */
+static void clause_review_format(void)
+{
+    const tokenDefinition_t *token = clause_token(clauseReview.content);
+
+    // fullAmount holds the field on screen from now on
+    reviewValuesReady &= ~REVIEW_VALUE_BIT(REVIEW_VALUE_AMOUNT);
+    if (clauseReview.totals) {
+        // The recipients of a sequence come first
+        uint8_t recipients = review_recipients_count();
+        if (clauseReview.field < recipients) {
+            snprintf((char *)reviewTitle, sizeof(reviewTitle), "To (%d/%d)", clauseReview.field + 1, recipients);
+            review_recipient_format(clauseReview.field, (char *)fullAmount);
+            return;
+        }
+        snprintf((char *)reviewTitle, sizeof(reviewTitle), "Total (%d/%d)", clauseReview.field - recipients + 1,
+                 clauseReview.fieldCount - recipients);
+        review_total_format(clauseReview.field - recipients, (char *)fullAmount);
+        return;
+    }
+    switch (clauseReview.field) {
+    case CLAUSE_FIELD_AMOUNT:
+        snprintf((char *)reviewTitle, sizeof(reviewTitle), "Amount (%d)", clauseReview.index + 1);
+        clause_amount_format(clauseReview.content, token, (char *)fullAmount);
+        break;
+    case CLAUSE_FIELD_ADDRESS:
+        snprintf((char *)reviewTitle, sizeof(reviewTitle), "Address (%d)", clauseReview.index + 1);
+        clause_address_format(clauseReview.content, token, (char *)fullAmount);
+        break;
+    default:
+        if (N_storage.expertMode) {
+            char title[16];
+            calldata_page_format(&clauseReview.content->data, clauseReview.field - CLAUSE_FIELD_DATA, title,
+                                 sizeof(title), (char *)fullAmount);
+            snprintf((char *)reviewTitle, sizeof(reviewTitle), "%s (%d)", title, clauseReview.index + 1);
+            break;
+        }
+        snprintf((char *)reviewTitle, sizeof(reviewTitle), "Data (%d)", clauseReview.index + 1);
+        snprintf((char *)fullAmount, sizeof(fullAmount), "Present");
+        break;
+    }
+}
+
+/**
+ * @brief Moves the clause review to the totals per asset, once the last clause has been parsed.
+ *
+ * @details For a sequence of transactions, its recipients are reviewed ahead of the totals.
+ */
+static void clause_review_totals(void)
+{
+    clauseReview.complete = true;
+    clauseReview.totals = true;
+    clauseReview.inside = true;
+    clauseReview.field = 0;
+    clauseReview.fieldCount = review_recipients_count() + review_totals_count();
+    clause_review_format();
+}
+
+/**
+ * @brief Shows the clause the parser has been suspended after.
+ *
+ * @details The review starts with the first clause, when more clauses follow it.
+ * The reply of the data block is sent once the user has reviewed the clause.
+ */
+static void clause_review_show(void)
+{
+    if (G_ux.stack_count == 0) {
+        ux_stack_push();
+    }
+    if (!clauseReview.active) {
+        if (!N_storage.multiClauseAllowed) {
+            PRINTF("Multiple clauses forbidden\n");
+            THROW(HW_INCORRECT_DATA);
+        }
+        clauseReview.active = true;
+        clauseReview.dataWarning = (clauseReview.fieldCount > CLAUSE_FIELD_DATA);
+        review_subtitle_set();
+        ux_flow_init(0, clauseReview.dataWarning ? ux_confirm_data_clauses_flow : ux_confirm_clauses_flow, NULL);
+    } else {
+        clauseReview.inside = true;
+        clause_review_format();
+        ux_flow_init(0, clauseReview.dataWarning ? ux_confirm_data_clauses_flow : ux_confirm_clauses_flow,
+                     &ux_confirm_clause_step);
+    }
+}
+
+/**
+ * @brief Parses the transaction up to the next clause, once the user has reviewed the previous one.
+ *
+ * @details Called from the review steps: errors are replied to the pending data block.
+ */
+static void clause_review_resume(void)
+{
+    BEGIN_TRY {
+        TRY {
+            // The end of the data block is still in the APDU buffer, not replied yet
+            switch (sign_tx_parse(displayContext.txFullContext.txContext.workBuffer,
+                                  displayContext.txFullContext.txContext.commandLength)) {
+            case USTREAM_SUSPENDED:
+                clause_review_format();
+                ux_flow_prev();
+                break;
+            case USTREAM_PROCESSING:
+                // The next clause is in the next data block
+                io_seproxyhal_send_status(HW_OK);
+                ux_flow_init(0, ux_confirm_clause_wait_flow, NULL);
+                break;
+            case USTREAM_FINISHED:
+                CX_ASSERT(cx_hash_no_throw((cx_hash_t *)&blake2b, CX_LAST, NULL, 0, tmpCtx.transactionContext.hash, 32));
+                TRACE(TRACE_HASH_DONE, 0, (tmpCtx.transactionContext.hash[0] << 8) | tmpCtx.transactionContext.hash[1]);
+                sign_tx_prepare_review();
+                clause_review_totals();
+                ux_flow_prev();
+                break;
+            default:
+                THROW(HW_INCORRECT_DATA);
+            }
+        }
+        CATCH(EXCEPTION_IO_RESET) {
+            THROW(EXCEPTION_IO_RESET);
+        }
+        CATCH_OTHER(e) {
+            // The transaction cannot be signed any more
+            memset(&clauseReview, 0, sizeof(clauseReview));
+            sign_session_end();
+            io_seproxyhal_send_status(((e & ERROR_TYPE_MASK) == ERROR_TYPE_HW) ? e : (0x6800 | (e & 0x7FF)));
+            ui_idle();
+        }
+        FINALLY {
+        }
+    }
+    END_TRY;
+}
+
+/**
+ * @brief Steps around the clause on screen, moving from field to field and from clause to clause.
+ *
+ * @details The previous clauses are not kept: going back stops at the first field of the clause.
+ * The recipients and totals of a sequence are all kept, going back from them leads to its sender.
+ *
+ * @param[in] upper True for the step before the clause, false for the step after it.
+ */
+static void clause_review_step(bool upper)
+{
+    if (upper) {
+        if (!clauseReview.inside) {
+            // Entering the clause from the warnings
+            clauseReview.inside = true;
+        } else if (clauseReview.field != 0) {
+            clauseReview.field--;
+        } else if (clauseReview.sequence) {
+            // Leaving the recipients back to the sender
+            clauseReview.inside = false;
+            ux_flow_prev();
+            return;
+        }
+        clause_review_format();
+        ux_flow_next();
+    } else {
+        if (!clauseReview.inside) {
+            // Entering the clause back from the fees
+            clauseReview.inside = true;
+            clause_review_format();
+            ux_flow_prev();
+        } else if (clauseReview.field + 1 < clauseReview.fieldCount) {
+            clauseReview.field++;
+            clause_review_format();
+            ux_flow_prev();
+        } else if (clauseReview.complete) {
+            // Leaving the totals for the fees
+            clauseReview.inside = false;
+            ux_flow_next();
+        } else {
+            clause_review_resume();
+        }
+    }
+}
+
+/**
+ * @brief Formats the page of the data on screen into the shared display buffers.
+ */
+static void calldata_review_format(void)
+{
+    // fullAmount holds the page on screen from now on
+    reviewValuesReady &= ~REVIEW_VALUE_BIT(REVIEW_VALUE_AMOUNT);
+    calldata_page_format(&clauseContent.data, calldataReview.page, (char *)reviewTitle, sizeof(reviewTitle),
+                         (char *)fullAmount);
+}
+
+/**
+ * @brief Steps around the page of the data on screen, in the expert review of a single clause.
+ *
+ * @param[in] upper True for the step before the page, false for the step after it.
+ */
+static void calldata_review_step(bool upper)
+{
+    uint8_t count = calldata_page_count(&clauseContent.data);
+
+    if (upper) {
+        if (!calldataReview.inside) {
+            // Entering the data from the address
+            calldataReview.inside = true;
+            calldataReview.page = 0;
+        } else if (calldataReview.page == 0) {
+            // Leaving the data back to the address
+            calldataReview.inside = false;
+            ux_flow_prev();
+            return;
+        } else {
+            calldataReview.page--;
+        }
+        calldata_review_format();
+        ux_flow_next();
+    } else {
+        if (!calldataReview.inside) {
+            // Entering the data back from the fees
+            calldataReview.inside = true;
+            calldataReview.page = count - 1;
+        } else if (calldataReview.page + 1 < count) {
+            calldataReview.page++;
+        } else {
+            // Leaving the data for the fees
+            calldataReview.inside = false;
+            ux_flow_next();
+            return;
+        }
+        calldata_review_format();
+        ux_flow_prev();
+    }
+}
+
+/**
+ * @brief Rejects the transaction during the review of its clauses.
+ *
+ * @details The signing session ends, so that the following data blocks of the transaction are
+ * answered with HW_SW_TRANSACTION_CANCELLED. The reply of the data block waiting for the review
+ * is sent with the same status; none is pending while the next clause is loading.
+ *
+ * @param[in] replyPending True if the host waits for the reply of a data block.
+ *
+ * @return 0 indicating that the widget should not be redrawn.
+ */
+static unsigned int clause_review_reject(bool replyPending)
+{
+    memset(&clauseReview, 0, sizeof(clauseReview));
+    sign_session_end();
+    if (replyPending) {
+        return io_seproxyhal_touch_cancel();
+    }
+    speculative_sign_wipe();
+    ui_idle();
+    return 0; // do not redraw the widget
+}
+
+/**
+ * @brief Leaves the review of the clauses after an error, back to the main menu.
+ */
+static void clause_review_abort(void)
+{
+    if (clauseReview.active) {
+        memset(&clauseReview, 0, sizeof(clauseReview));
+        ui_idle();
+    }
+}
+#endif
+
+/**
+ * @brief Handles the signing of a transaction.
+ *
+ * @details This function handles the signing of a transaction. It supports both the first
+ * part of the transaction and subsequent parts. It follows these steps:
+ * - Parses the input parameters to determine the action to be taken.
+ * - Initializes the transaction context and prepares for transaction processing.
+ * - Processes the transaction data, including path extraction, clause content, and data presence.
+ * - Stores the transaction hash and performs necessary checks.
+ * - Prepares the display or UI for confirming the transaction signing action.
+ *
+ * @note With P2_SIGN_MULTI_PATH, the first part starts with a list of BIP32 paths instead of a single one.
+ * The transaction is parsed, hashed and reviewed once, and one signature per path is returned after
+ * the approval. Signatures that do not fit in the response are fetched with P1_NEXT_SIGNATURES.
+ *
+ * @note With P2_SIGN_DELEGATOR, the BIP32 path is followed by the address of the transaction sender.
+ * The transaction must enable the VIP-191 fee delegation feature, and the device signs
+ * blake2b(signingHash || origin) as the gas payer after the user reviewed the sender and the fee.
+ *
+ * @note With P2_SIGN_SEQUENCE, the BIP32 path is followed by the number of transactions (max
+ * MAX_SEQUENCE_LENGTH). Each following transaction starts with P1_NEXT_TRANSACTION and carries a
+ * 32 bytes dependsOn placeholder, replaced while hashing by the ID of the previous transaction.
+ * The ID of each transaction but the last is sent back when it has been parsed. After a single
+ * review of the sequence, the signatures are returned along with the transaction IDs.
+ *
+ * @note On NBGL devices, a transaction of P2_SIGN_SINGLE_PATH or P2_SIGN_MULTI_PATH sent in several
+ * data blocks is reviewed while it is streamed: the review starts after the first block and each
+ * clause is appended to it once parsed. Once too many parsed clauses wait for the user, the parser is
+ * suspended and the reply of the data block is sent after the user has reviewed one of them.
+ *
+ * @note On BAGL devices, a transaction of P2_SIGN_SINGLE_PATH or P2_SIGN_MULTI_PATH with multiple
+ * clauses is reviewed clause by clause: the parser is suspended after each clause, and the reply of
+ * the data block is sent once the user has reviewed the clauses it completes.
+ *
+ * @param[in] p1 Instruction parameter 1 (P1), indicating the type of transaction signing action.
+ *        If set to P1_FIRST, it indicates the beginning of a new signing operation.
+ *        If set to P1_MORE, it indicates further parts of the signing operation.
+ *        If set to P1_NEXT_TRANSACTION, it indicates the beginning of the next transaction of a sequence.
+ *        If set to P1_NEXT_SIGNATURES, it requests the next signatures of an approved multi-path signature.
+ * @param[in] p2 Instruction parameter 2 (P2), indicating the signing mode (P2_SIGN_SINGLE_PATH,
+ *        P2_SIGN_MULTI_PATH, P2_SIGN_DELEGATOR or P2_SIGN_SEQUENCE).
+ * @param[in] workBuffer Pointer to the data buffer containing the transaction data.
+ * @param[in] dataLength Length of the transaction data.
+ * @param[in,out] flags Pointer to flags for APDU processing.
+ * @param[in,out] tx Pointer to the outgoing APDU buffer size.
+ */
+void handleSign(uint8_t p1, uint8_t p2, uint8_t workBuffer[static 255],
+                uint16_t dataLength, volatile unsigned int flags[static 1],
+                volatile unsigned int tx[static 1])
+{
+    parserStatus_e txResult;
+
+    if (p1 == P1_NEXT_SIGNATURES) {
+        // Only valid right after the approval of a multi-path signature
+        if ((signatureBatch.next == 0) || !signatureBatch.multiple) {
+            THROW(HW_SW_TRANSACTION_CANCELLED);
+        }
+        *tx = set_result_signatures();
+        THROW(HW_OK);
+    }
+
+    if (p1 == P1_FIRST) {
+        sign_session_start(INS_SIGN);
+        memset(&clausesContent, 0, sizeof(clausesContent));
+        memset(&clauseContent, 0, sizeof(clauseContent));
+
+        // Extract and parse the BIP32 path(s)
+        if (p2 == P2_SIGN_MULTI_PATH) {
+            parseBip32PathList(&workBuffer, &dataLength);
+        } else {
+            parseBip32Path(&workBuffer, &dataLength, &tmpCtx.transactionContext.pathLength, tmpCtx.transactionContext.bip32Path);
+            tmpCtx.transactionContext.extraPathCount = 0;
+        }
+        // Extract the sender of the transaction when signing as the gas payer
+        if (p2 == P2_SIGN_DELEGATOR) {
+            if (dataLength < sizeof(tmpCtx.transactionContext.origin)) {
+                THROW(HW_INCORRECT_DATA);
+            }
+            memmove(tmpCtx.transactionContext.origin, workBuffer, sizeof(tmpCtx.transactionContext.origin));
+            workBuffer += sizeof(tmpCtx.transactionContext.origin);
+            dataLength -= sizeof(tmpCtx.transactionContext.origin);
+        }
+        // Extract the number of transactions of the sequence
+        if (p2 == P2_SIGN_SEQUENCE) {
+            if (dataLength < 1) {
+                THROW(HW_INCORRECT_DATA);
+            }
+            if ((workBuffer[0] < 1) || (workBuffer[0] > MAX_SEQUENCE_LENGTH)) {
+                THROW(HW_INCORRECT_DATA);
+            }
+            tmpCtx.transactionContext.sequenceLength = workBuffer[0];
+            tmpCtx.transactionContext.sequenceIndex = 0;
+            memset(&tmpCtx.transactionContext.sequenceFee, 0, sizeof(tmpCtx.transactionContext.sequenceFee));
+            tmpCtx.transactionContext.recipientCount = 0;
+            workBuffer++;
+            dataLength--;
+            deriveSequenceSigner();
+        }
+        tmpCtx.transactionContext.signMode = p2;
+        dataPresent = false;
+        initTx(&displayContext.txFullContext.txContext, &tmpContent.txContent,
+               &displayContext.txFullContext.clausesContext, &clausesContent,
+               &displayContext.txFullContext.clauseContext, &clauseContent,
+               &blake2b, NULL);
+#ifdef HAVE_NBGL
+        ui_stream_review_reset();
+#else
+        memset(&clauseReview, 0, sizeof(clauseReview));
+        memset(&calldataReview, 0, sizeof(calldataReview));
+#endif
+        asset_totals_reset();
+        // Clauses are handed to the review as they are parsed
+        if ((p2 == P2_SIGN_SINGLE_PATH) || (p2 == P2_SIGN_MULTI_PATH)) {
+            displayContext.txFullContext.clausesContext.nextClause = &nextClauseContent;
+            displayContext.txFullContext.clausesContext.clauseDone = review_clause_done;
+#ifdef HAVE_NBGL
+            // For a review started before the last block
+            review_subtitle_set();
+#else
+            // Each clause is reviewed before the next one is parsed
+            displayContext.txFullContext.clausesContext.suspendAfterClause = true;
+#endif
+        }
+        if (p2 == P2_SIGN_SEQUENCE) {
+            // The recipients and totals of all the transactions are reviewed after the last one
+            displayContext.txFullContext.clausesContext.nextClause = &nextClauseContent;
+            displayContext.txFullContext.clausesContext.clauseDone = sequence_clause_done;
+        }
+    } else if (p1 == P1_NEXT_TRANSACTION) {
+        sign_session_check(INS_SIGN);
+        // Only valid once the previous transaction of a sequence has been parsed
+        if ((p2 != P2_SIGN_SEQUENCE) || (tmpCtx.transactionContext.signMode != P2_SIGN_SEQUENCE) ||
+            (tmpCtx.transactionContext.sequenceIndex == 0) ||
+            (tmpCtx.transactionContext.sequenceIndex >= tmpCtx.transactionContext.sequenceLength) ||
+            (displayContext.txFullContext.txContext.currentField != TX_RLP_NONE)) {
+            THROW(HW_SW_TRANSACTION_CANCELLED);
+        }
+        memset(&clausesContent, 0, sizeof(clausesContent));
+        memset(&clauseContent, 0, sizeof(clauseContent));
+        initTx(&displayContext.txFullContext.txContext, &tmpContent.txContent,
+               &displayContext.txFullContext.clausesContext, &clausesContent,
+               &displayContext.txFullContext.clauseContext, &clauseContent,
+               &blake2b, NULL);
+        displayContext.txFullContext.txContext.dependsOn = tmpCtx.transactionContext.dependsOn;
+        displayContext.txFullContext.clausesContext.nextClause = &nextClauseContent;
+        displayContext.txFullContext.clausesContext.clauseDone = sequence_clause_done;
+    } else if (p1 == P1_MORE) {
+        sign_session_check(INS_SIGN);
+    } else {
+        THROW(HW_INCORRECT_P1_P2);
+    }
+    if (((p2 != P2_SIGN_SINGLE_PATH) && (p2 != P2_SIGN_MULTI_PATH) && (p2 != P2_SIGN_DELEGATOR) &&
+         (p2 != P2_SIGN_SEQUENCE)) ||
+        (p2 != tmpCtx.transactionContext.signMode)) {
+        THROW(HW_INCORRECT_P1_P2);
+    }
+    if (displayContext.txFullContext.txContext.currentField == TX_RLP_NONE) {
+        PRINTF("Parser not initialized\n");
+        THROW(HW_SW_TRANSACTION_CANCELLED);
+    }
+    if (displayContext.txFullContext.clausesContext.currentField == CLAUSES_RLP_NONE) {
+        PRINTF("Parser not initialized\n");
+        THROW(HW_SW_TRANSACTION_CANCELLED);
+    }
+    txResult = sign_tx_parse(workBuffer, dataLength);
+#ifdef HAVE_BAGL
+    if ((txResult == USTREAM_SUSPENDED) && !clauseReview.active &&
+        (displayContext.txFullContext.txContext.currentField != TX_RLP_CLAUSES)) {
+        // A single clause is reviewed along with the whole transaction
+        displayContext.txFullContext.clausesContext.suspendAfterClause = false;
+        txResult = sign_tx_parse(displayContext.txFullContext.txContext.workBuffer,
+                                 displayContext.txFullContext.txContext.commandLength);
+    }
+#endif
+    switch (txResult) {
+    case USTREAM_FINISHED:
+        break;
+    case USTREAM_SUSPENDED:
+#ifdef HAVE_BAGL
+        // Replied once the user has reviewed the clause
+        clause_review_show();
+#else
+        // The queue of the review is full, replied once the user has reviewed one of its clauses
+        stream_review_warning_set();
+        ui_stream_review_start();
+        ui_stream_review_hold();
+#endif
+        *flags |= IO_ASYNCH_REPLY;
+        return;
+    case USTREAM_PROCESSING:
+#ifdef HAVE_NBGL
+        if (displayContext.txFullContext.clausesContext.clauseDone != NULL) {
+            // The user reviews the first clauses while the next blocks are sent
+            stream_review_warning_set();
+            ui_stream_review_start();
+        }
+#endif
+        THROW(HW_OK);
+    case USTREAM_FAULT:
+        THROW(HW_INCORRECT_DATA);
+    default:
+        PRINTF("Unexpected parser status\n");
+        THROW(HW_INCORRECT_DATA);
+    }
+
+    // Store the hash
+    PROFILE_BEGIN(PROFILE_HASH);
+    if ((tmpCtx.transactionContext.signMode == P2_SIGN_SEQUENCE) &&
+        (tmpCtx.transactionContext.sequenceIndex != 0)) {
+        CX_ASSERT(cx_hash_no_throw((cx_hash_t *)&blake2b, CX_LAST, NULL, 0,
+                                   tmpCtx.transactionContext.sequenceHash[tmpCtx.transactionContext.sequenceIndex - 1], 32));
+        PROFILE_END(PROFILE_HASH);
+        handleSignSequence(flags, tx);
+        return;
+    }
+    CX_ASSERT(cx_hash_no_throw((cx_hash_t *)&blake2b, CX_LAST, NULL, 0, tmpCtx.transactionContext.hash, 32));
+    PROFILE_END(PROFILE_HASH);
+
+    TRACE(TRACE_HASH_DONE, 0, (tmpCtx.transactionContext.hash[0] << 8) | tmpCtx.transactionContext.hash[1]);
+
+    if (tmpCtx.transactionContext.signMode == P2_SIGN_SEQUENCE) {
+        handleSignSequence(flags, tx);
+        return;
+    }
+
+    if (tmpCtx.transactionContext.signMode == P2_SIGN_DELEGATOR) {
+        handleSignDelegation(flags);
+        return;
+    }
+
+    sign_tx_prepare_review();
+
+#ifdef HAVE_BAGL
+    if(G_ux.stack_count == 0) {
+    ux_stack_push();
+    }
+    if (clauseReview.active) {
+        // The clauses have been reviewed while parsed, the totals and the fees end the review
+        clause_review_totals();
+        ux_flow_init(0, clauseReview.dataWarning ? ux_confirm_data_clauses_flow : ux_confirm_clauses_flow,
+                     &ux_confirm_clause_step);
+    }
+    else if(dataPresent){
+        ux_flow_init(0, (review_calldata() != NULL) ? ux_confirm_full_calldata_flow : ux_confirm_full_data_flow, NULL);
+    }
+    else{
+        ux_flow_init(0, ux_confirm_full_flow, NULL);
+    }
+#else
+    if (ui_stream_review_started()) {
+        // The fees end the review already displayed
+        ui_stream_review_finish();
+    } else {
+        ui_stream_review_reset();
+        ui_display_action_sign_tx_flow();
+    }
+#endif
+
+    *flags |= IO_ASYNCH_REPLY;
+}
+
+/**
+ * @brief Retrieves the application configuration settings and version information.
+ *
+ * @details This function retrieves the application configuration settings and version information
+ * for the current application. It follows these steps:
+ * - Retrieves the application configuration settings from non-volatile storage.
+ * - Retrieves the major, minor, and patch version numbers of the application.
+ * - Sets the outgoing APDU buffer with the configuration settings and version information.
+ * - Sets the outgoing APDU buffer size to indicate the number of bytes transmitted.
+ *
+ * @note Settings values:
+ * - 0: Both data and multiple clauses disabled.
+ * - 1: Data enabled, multiple clauses disabled.
+ * - 2: Data disabled, multiple clauses enabled.
  * - 3: Both data and multiple clauses enabled.
+ * - Bit 2 (0x04) is set on top of these when the expert mode is enabled.
  *
  * @param[in] p1 Instruction parameter 1 (P1), currently unused.
  * @param[in] p2 Instruction parameter 2 (P2), currently unused.
@@ -1229,7 +3246,8 @@ void handleGetAppConfiguration(uint8_t p1, uint8_t p2, uint8_t workBuffer[static
     // Retrieve configuration settings
     G_io_apdu_buffer[0] = (
         (N_storage.dataAllowed ? CONFIG_DATA_ENABLED : 0x00) |
-        (N_storage.multiClauseAllowed ? CONFIG_MULTICLAUSE_ENABLED<<1 : 0x00)
+        (N_storage.multiClauseAllowed ? CONFIG_MULTICLAUSE_ENABLED<<1 : 0x00) |
+        (N_storage.expertMode ? CONFIG_EXPERT_MODE_ENABLED<<2 : 0x00)
     );
 
     // Retrieve version information
@@ -1250,11 +3268,13 @@ void handleGetAppConfiguration(uint8_t p1, uint8_t p2, uint8_t workBuffer[static
  * - Parses the input parameters to determine the action to be taken.
  * - Initializes the certificate signing context and computes the certificate header.
  * - Updates the certificate hash with the certificate data for subsequent parts.
+ * - Tokenizes the certificate in the same pass, keeping the fields displayed and rejecting
+ *   malformed or non-canonical JSON as soon as it is received.
  * - Finalizes the certificate hash and generates the certificate signature when the entire certificate is processed.
  * - Prepares the display or UI for confirming the certificate signing action.
  *
  * @note This function assumes the following:
- *       - The certificate data is in JSON format.
+ *       - The certificate data is the canonical JSON of a certificate: sorted keys, no whitespace.
  *       - The BIP32 path for the key derivation is provided before the certificate data.
  *       - The certificate signing operation may involve multiple parts.
  *
@@ -1273,10 +3293,13 @@ void handleSignCertificate(uint8_t p1, uint8_t p2, uint8_t workBuffer[static 255
                            volatile unsigned int flags[static 1],
                            volatile unsigned int tx[static 1])
 {
+    parserStatus_e certResult;
+
     UNUSED(tx);
 
     // Process the first part of the certificate signing operation
     if (p1 == P1_FIRST) {
+        sign_session_start(INS_SIGN_CERTIFICATE);
 
         // Extract and parse the BIP32 path
         parseBip32Path(&workBuffer, &dataLength, &tmpCtx.transactionContext.pathLength, tmpCtx.transactionContext.bip32Path);
@@ -1285,18 +3308,15 @@ void handleSignCertificate(uint8_t p1, uint8_t p2, uint8_t workBuffer[static 255
         tmpCtx.messageSigningContext.remainingLength =
             (workBuffer[0] << 24) | (workBuffer[1] << 16) |
             (workBuffer[2] << 8) | (workBuffer[3]);
-        workBuffer += 4;
-        dataLength -= 4;
-
-        // Check if the certificate starts with '{' (indicating JSON format)
-        if (workBuffer[0] != '{') {
-            PRINTF("Invalid json\n");
-            THROW(HW_INCORRECT_DATA);
-        }
+        workBuffer += 4;
+        dataLength -= 4;
 
         // Initialize Blake2b hash function with a 256-bit output size
         CX_ASSERT(cx_blake2b_init_no_throw(&blake2b, 256));
-    } else if (p1 != P1_MORE) {
+        initCertificate(&displayContext.certificateContext, &tmpCtx.messageSigningContext.certificate);
+    } else if (p1 == P1_MORE) {
+        sign_session_check(INS_SIGN_CERTIFICATE);
+    } else {
         THROW(HW_INCORRECT_P1_P2);
     }
     if (p2 != 0) {
@@ -1306,20 +3326,23 @@ void handleSignCertificate(uint8_t p1, uint8_t p2, uint8_t workBuffer[static 255
         THROW(HW_NOT_ENOUGH_MEMORY_SPACE);
     }
 
-    // Update message hash with certificate data
+    // Update message hash with certificate data, and extract the fields displayed in the same pass
     CX_ASSERT(cx_hash_no_throw((cx_hash_t *)&blake2b, 0, workBuffer, dataLength, NULL, 0));
+    certResult = processCertificate(&displayContext.certificateContext, workBuffer, dataLength);
     tmpCtx.messageSigningContext.remainingLength -= dataLength;
+    if ((certResult == USTREAM_FAULT) ||
+        ((certResult == USTREAM_FINISHED) != (tmpCtx.messageSigningContext.remainingLength == 0))) {
+        PRINTF("Invalid certificate\n");
+        THROW(HW_INCORRECT_DATA);
+    }
 
     // Check if all certificate data has been processed
     if (tmpCtx.messageSigningContext.remainingLength == 0) {
-        // Check if the certificate ends with '}' (indicating JSON format)
-        if (workBuffer[dataLength-1] != '}') {
-            PRINTF("Invalid json\n");
-            THROW(HW_INCORRECT_DATA);
-        }
 
         // Finalize message hash
+        PROFILE_BEGIN(PROFILE_HASH);
         CX_ASSERT(cx_hash_no_throw((cx_hash_t *)&blake2b, CX_LAST, NULL, 0, tmpCtx.messageSigningContext.hash, 32));
+        PROFILE_END(PROFILE_HASH);
 
         // Convert the message hash to hexadecimal string
 #define HASH_LENGTH 4
@@ -1332,12 +3355,20 @@ void handleSignCertificate(uint8_t p1, uint8_t p2, uint8_t workBuffer[static 255
         array_hexstr((char *)fullAddress + HASH_LENGTH / 2 * 2 + 3,
                      tmpCtx.messageSigningContext.hash + 32 - HASH_LENGTH / 2, HASH_LENGTH / 2);
 
+        // Start signing in the background while the user reviews the certificate
+        signature_batch_init(1, false);
+        speculative_sign_schedule();
+
 #ifdef HAVE_BAGL
         // If BAGL is supported, push a new screen stack and initialize UI flow
         if(G_ux.stack_count == 0) {
             ux_stack_push();
         }
-        ux_flow_init(0, ux_sign_cert_flow, NULL);
+        ux_flow_init(0,
+                     (tmpCtx.messageSigningContext.certificate.fields & CERT_FIELD_BIT(CERT_FIELD_SIGNER))
+                         ? ux_sign_cert_signer_flow
+                         : ux_sign_cert_flow,
+                     NULL);
 #else
         // Display the action for signing a certificate
         ui_display_action_sign_msg_cert(CERTIFICATE_TRANSACTION);
@@ -1350,6 +3381,135 @@ void handleSignCertificate(uint8_t p1, uint8_t p2, uint8_t workBuffer[static 255
     }
 }
 
+/**
+ * @brief Keeps the leading bytes of a personal message for its review.
+ *
+ * @param[in] data Data block of the message.
+ * @param[in] length Length of the data block.
+ */
+static void message_preview_add(const uint8_t *data, uint32_t length)
+{
+    uint32_t room = MESSAGE_PREVIEW_LENGTH - tmpCtx.messageSigningContext.previewLength;
+
+    if (length > room) {
+        tmpCtx.messageSigningContext.previewTruncated = true;
+        length = room;
+    }
+    memmove(tmpCtx.messageSigningContext.preview + tmpCtx.messageSigningContext.previewLength, data, length);
+    tmpCtx.messageSigningContext.previewLength += length;
+}
+
+/**
+ * @brief Tells whether the leading bytes of a personal message can be displayed as text.
+ *
+ * @details Printable ASCII is displayed on all devices. NBGL devices also display line feeds
+ * and UTF-8 sequences, a sequence cut by the end of the kept bytes being dropped.
+ *
+ * @param[in,out] length Number of bytes kept, reduced to the bytes displayed.
+ *
+ * @return True if the bytes are text.
+ */
+static bool message_preview_is_text(uint16_t *length)
+{
+    const uint8_t *data = (const uint8_t *)tmpCtx.messageSigningContext.preview;
+    uint16_t i = 0;
+#ifdef HAVE_NBGL
+    uint16_t j;
+    uint8_t extra;
+#endif
+
+    while (i < *length) {
+        if ((data[i] >= 0x20) && (data[i] < 0x7F)) {
+            i++;
+            continue;
+        }
+#ifdef HAVE_NBGL
+        if (data[i] == '\n') {
+            i++;
+            continue;
+        }
+        if ((data[i] >= 0xC2) && (data[i] <= 0xDF)) {
+            extra = 1;
+        } else if ((data[i] >= 0xE0) && (data[i] <= 0xEF)) {
+            extra = 2;
+        } else if ((data[i] >= 0xF0) && (data[i] <= 0xF4)) {
+            extra = 3;
+        } else {
+            return false;
+        }
+        for (j = 1; (j <= extra) && (i + j < *length); j++) {
+            if ((data[i + j] & 0xC0) != 0x80) {
+                return false;
+            }
+        }
+        if (j <= extra) {
+            if (!tmpCtx.messageSigningContext.previewTruncated) {
+                return false;
+            }
+            // Cut by the end of the preview, not by the end of the message
+            *length = i;
+            break;
+        }
+        i += extra + 1;
+        continue;
+#else
+        return false;
+#endif
+    }
+    return true;
+}
+
+/**
+ * @brief Turns the leading bytes of a complete personal message into the text displayed.
+ *
+ * @details Bytes which are not text are displayed in hex, the first half of them only.
+ */
+static void message_preview_finish(void)
+{
+    char *preview = tmpCtx.messageSigningContext.preview;
+    uint16_t length = tmpCtx.messageSigningContext.previewLength;
+    uint16_t i;
+
+    if (!message_preview_is_text(&length)) {
+        if (length > MESSAGE_PREVIEW_LENGTH / 2) {
+            length = MESSAGE_PREVIEW_LENGTH / 2;
+            tmpCtx.messageSigningContext.previewTruncated = true;
+        }
+        // In place, from the last byte: a byte is read before its hex digits overwrite it
+        for (i = length; i-- != 0;) {
+            uint8_t byte = preview[i];
+            preview[2 * i] = hex_digits[byte >> 4];
+            preview[2 * i + 1] = hex_digits[byte & 0xF];
+        }
+        length *= 2;
+    }
+    if (tmpCtx.messageSigningContext.previewTruncated) {
+        memmove(preview + length, "...", 3);
+        length += 3;
+    }
+    preview[length] = '\0';
+}
+
+/**
+ * @brief Gets the text of the personal message being reviewed.
+ *
+ * @return The leading bytes of the message as text or in hex, empty for an empty message.
+ */
+const char *message_preview(void)
+{
+    return tmpCtx.messageSigningContext.preview;
+}
+
+/**
+ * @brief Gets the fields of the certificate being reviewed.
+ *
+ * @return The fields extracted while the certificate was hashed.
+ */
+const certificateContent_t *certificate_content(void)
+{
+    return &tmpCtx.messageSigningContext.certificate;
+}
+
 /**
  * @brief Handles the signing of a personal message.
  *
@@ -1382,6 +3542,8 @@ void handleSignPersonalMessage(uint8_t p1, uint8_t p2, uint8_t workBuffer[static
         uint32_t base = 10;
         uint8_t pos = 0;
 
+        sign_session_start(INS_SIGN_PERSONAL_MESSAGE);
+
         // Extract and parse the BIP32 path
         parseBip32Path(&workBuffer, &dataLength, &tmpCtx.transactionContext.pathLength, tmpCtx.transactionContext.bip32Path);
 
@@ -1413,7 +3575,12 @@ void handleSignPersonalMessage(uint8_t p1, uint8_t p2, uint8_t workBuffer[static
 
         // Hash the message header + length
         CX_ASSERT(cx_hash_no_throw((cx_hash_t *)&blake2b, 0, (uint8_t *)tmp, pos, NULL, 0));
-    } else if (p1 != P1_MORE) {
+
+        tmpCtx.messageSigningContext.previewLength = 0;
+        tmpCtx.messageSigningContext.previewTruncated = false;
+    } else if (p1 == P1_MORE) {
+        sign_session_check(INS_SIGN_PERSONAL_MESSAGE);
+    } else {
         THROW(HW_INCORRECT_P1_P2);
     }
     if (p2 != 0) {
@@ -1423,15 +3590,18 @@ void handleSignPersonalMessage(uint8_t p1, uint8_t p2, uint8_t workBuffer[static
         THROW(HW_NOT_ENOUGH_MEMORY_SPACE);
     }
 
-    // Update message hash with message data
+    // Update message hash with message data, keeping its first bytes for the review
     CX_ASSERT(cx_hash_no_throw((cx_hash_t *)&blake2b, 0, workBuffer, dataLength, NULL, 0));
+    message_preview_add(workBuffer, dataLength);
     // Decrease the remaining length by the processed data length
     tmpCtx.messageSigningContext.remainingLength -= dataLength;
 
     // Check if all message data has been processed
     if (tmpCtx.messageSigningContext.remainingLength == 0) {
         // Finalize message hash
+        PROFILE_BEGIN(PROFILE_HASH);
         CX_ASSERT(cx_hash_no_throw((cx_hash_t *)&blake2b, CX_LAST, NULL, 0, tmpCtx.messageSigningContext.hash, 32));
+        PROFILE_END(PROFILE_HASH);
 
         // Convert the message hash to hexadecimal string
 #define HASH_LENGTH 4
@@ -1445,12 +3615,18 @@ void handleSignPersonalMessage(uint8_t p1, uint8_t p2, uint8_t workBuffer[static
         array_hexstr((char *)fullAddress + HASH_LENGTH / 2 * 2 + 3,
                      tmpCtx.messageSigningContext.hash + 32 - HASH_LENGTH / 2, HASH_LENGTH / 2);
 
+        message_preview_finish();
+
+        // Start signing in the background while the user reviews the message
+        signature_batch_init(1, false);
+        speculative_sign_schedule();
+
 #ifdef HAVE_BAGL
     // If BAGL is supported, push a new screen stack and initialize UI flow
     if(G_ux.stack_count == 0) {
     ux_stack_push();
     }
-    ux_flow_init(0, ux_sign_msg_flow, NULL);
+    ux_flow_init(0, (message_preview()[0] != '\0') ? ux_sign_msg_preview_flow : ux_sign_msg_flow, NULL);
 #else
         // Display the action for signing a message
         ui_display_action_sign_msg_cert(MSG_TRANSACTION);
@@ -1465,6 +3641,283 @@ void handleSignPersonalMessage(uint8_t p1, uint8_t p2, uint8_t workBuffer[static
     }
 }
 
+/**
+ * @brief Sends back the last signing response.
+ *
+ * @details This function returns the last response of an approved signing request again,
+ * without parsing the request or asking the user to approve it twice. It follows these steps:
+ * - Checks that the device is unlocked, the response is wiped otherwise.
+ * - Checks that the signing hash given by the host matches the one of the last response.
+ * - Copies the last response to the APDU buffer.
+ *
+ * @note For a sequence of transactions, the key is the signing hash of the first transaction.
+ * When the response is split with P1_NEXT_SIGNATURES, only the last part sent is kept.
+ *
+ * @param[in] p1 Instruction parameter 1 (P1), must be 0.
+ * @param[in] p2 Instruction parameter 2 (P2), must be 0.
+ * @param[in] workBuffer Pointer to the signing hash of the request (32 bytes).
+ * @param[in] dataLength Length of the data buffer.
+ * @param[in,out] flags Pointer to flags for APDU processing (currently unused).
+ * @param[in,out] tx Pointer to the outgoing APDU buffer size.
+ */
+void handleGetLastResponse(uint8_t p1, uint8_t p2, uint8_t workBuffer[static 255],
+                           uint16_t dataLength,
+                           volatile unsigned int flags[static 1],
+                           volatile unsigned int tx[static 1])
+{
+    UNUSED(flags);
+
+    if ((p1 != 0) || (p2 != 0)) {
+        THROW(HW_INCORRECT_P1_P2);
+    }
+    if (dataLength != sizeof(lastResponse.hash)) {
+        THROW(HW_INCORRECT_DATA);
+    }
+    if (os_global_pin_is_validated() != BOLOS_UX_OK) {
+        last_response_wipe();
+        THROW(HW_SECURITY_STATUS_NOT_SATISFIED);
+    }
+    if (!lastResponse.valid || (memcmp(lastResponse.hash, workBuffer, sizeof(lastResponse.hash)) != 0)) {
+        THROW(HW_REFERENCED_DATA_NOT_FOUND);
+    }
+
+    memmove(G_io_apdu_buffer, lastResponse.data, lastResponse.length);
+    *tx = lastResponse.length;
+    THROW(HW_OK);
+}
+
+/**
+ * @brief Adds a trusted recipient to the address book, or removes it, once approved on screen.
+ *
+ * @details The clauses sent to an address of the book are reviewed with its label. It follows
+ * these steps:
+ * - Checks the address and its label, printable ASCII characters.
+ * - Checks that the book can take a new address, or that the removed one is in the book.
+ * - Displays the entry for approval, the book being written by io_seproxyhal_touch_address_book_ok().
+ *
+ * @param[in] p1 Instruction parameter 1 (P1), P1_ADDRESS_BOOK_ADD or P1_ADDRESS_BOOK_REMOVE.
+ * @param[in] p2 Instruction parameter 2 (P2), must be 0.
+ * @param[in] workBuffer Pointer to the address (20 bytes), followed by its label when added.
+ * @param[in] dataLength Length of the data buffer.
+ * @param[in,out] flags Pointer to flags for APDU processing.
+ * @param[in,out] tx Pointer to the outgoing APDU buffer size (currently unused).
+ */
+void handleAddressBook(uint8_t p1, uint8_t p2, uint8_t workBuffer[static 255],
+                       uint16_t dataLength,
+                       volatile unsigned int flags[static 1],
+                       volatile unsigned int tx[static 1])
+{
+    const char *label;
+    uint16_t i;
+
+    UNUSED(tx);
+
+    if (((p1 != P1_ADDRESS_BOOK_ADD) && (p1 != P1_ADDRESS_BOOK_REMOVE)) || (p2 != 0)) {
+        THROW(HW_INCORRECT_P1_P2);
+    }
+    if (dataLength < 20) {
+        THROW(HW_INCORRECT_DATA);
+    }
+    memset(&addressBookContext, 0, sizeof(addressBookContext));
+    addressBookContext.remove = (p1 == P1_ADDRESS_BOOK_REMOVE);
+    memmove(addressBookContext.address, workBuffer, 20);
+    workBuffer += 20;
+    dataLength -= 20;
+    label = address_book_lookup(addressBookContext.address);
+
+    if (addressBookContext.remove) {
+        if (dataLength != 0) {
+            THROW(HW_INCORRECT_DATA);
+        }
+        if (label == NULL) {
+            THROW(HW_REFERENCED_DATA_NOT_FOUND);
+        }
+        strncpy(addressBookContext.label, label, ADDRESS_BOOK_LABEL_LENGTH);
+    } else {
+        if ((dataLength == 0) || (dataLength > ADDRESS_BOOK_LABEL_LENGTH)) {
+            THROW(HW_INCORRECT_DATA);
+        }
+        for (i = 0; i < dataLength; i++) {
+            if ((workBuffer[i] < 0x20) || (workBuffer[i] > 0x7E)) {
+                THROW(HW_INCORRECT_DATA);
+            }
+        }
+        // A new label of a known address never needs a new slot
+        if ((label == NULL) && address_book_full()) {
+            THROW(HW_NOT_ENOUGH_MEMORY_SPACE);
+        }
+        memmove(addressBookContext.label, workBuffer, dataLength);
+    }
+
+    // The address of an interrupted review is formatted again if it is displayed
+    addressToDisplayString(addressBookContext.address, (uint8_t *)fullAddress);
+    reviewValuesReady &= ~REVIEW_VALUE_BIT(REVIEW_VALUE_ADDRESS);
+
+#ifdef HAVE_BAGL
+    if (G_ux.stack_count == 0) {
+        ux_stack_push();
+    }
+    ux_flow_init(0, addressBookContext.remove ? ux_address_book_remove_flow : ux_address_book_add_flow, NULL);
+#else
+    ui_display_address_book_flow();
+#endif
+
+    *flags |= IO_ASYNCH_REPLY;
+}
+
+/**
+ * @brief Gives the label of the address book entry under review.
+ */
+const char *address_book_entry_label(void)
+{
+    return addressBookContext.label;
+}
+
+/**
+ * @brief Tells whether the address book entry under review is removed.
+ */
+bool address_book_entry_removed(void)
+{
+    return addressBookContext.remove;
+}
+
+/**
+ * @brief Sends back the performance counters of the application.
+ *
+ * @details This function returns a page of counters kept by handleApdu() since the application
+ * started or since the last reset. It follows these steps:
+ * - Serializes the requested page to the APDU buffer.
+ * - Resets all the counters if requested, once they have been read.
+ *
+ * @note The STATS_PAGE_INS page contains, for each instruction, the number of calls, bytes in,
+ * bytes out, number of errors and last error status word.
+ *
+ * @note The STATS_PAGE_MEMORY page contains the stack size and its high-water mark since startup,
+ * or since the last reset of this page.
+ *
+ * @param[in] p1 Instruction parameter 1 (P1), page to read.
+ * @param[in] p2 Instruction parameter 2 (P2), P2_STATS_RESET to reset the counters after reading them.
+ * @param[in] workBuffer Pointer to the data buffer (currently unused).
+ * @param[in] dataLength Length of the data buffer (currently unused).
+ * @param[in,out] flags Pointer to flags for APDU processing (currently unused).
+ * @param[in,out] tx Pointer to the outgoing APDU buffer size.
+ */
+void handleGetStats(uint8_t p1, uint8_t p2, uint8_t workBuffer[static 255],
+                    uint16_t dataLength,
+                    volatile unsigned int flags[static 1],
+                    volatile unsigned int tx[static 1])
+{
+    UNUSED(workBuffer);
+    UNUSED(dataLength);
+    UNUSED(flags);
+
+    if ((p2 != P2_STATS_READ) && (p2 != P2_STATS_RESET)) {
+        THROW(HW_INCORRECT_P1_P2);
+    }
+    *tx = stats_write_page(p1, G_io_apdu_buffer, sizeof(G_io_apdu_buffer) - 2);
+    if (*tx == 0) {
+        THROW(HW_INCORRECT_P1_P2);
+    }
+    if (p2 == P2_STATS_RESET) {
+        stats_reset_page(p1);
+    }
+    THROW(HW_OK);
+}
+
+#ifdef TOKEN_SIGNER_PUBKEY
+/**
+ * @brief Adds a token to the well known tokens, from a descriptor signed by TOKEN_SIGNER_PUBKEY.
+ *
+ * @details The descriptor is verified once, its token being kept in RAM until the application
+ * exits. The transfers of the token are then reviewed as the transfers of the compiled in tokens.
+ *
+ * @param[in] p1 Instruction parameter 1 (P1), must be 0.
+ * @param[in] p2 Instruction parameter 2 (P2), must be 0.
+ * @param[in] workBuffer Pointer to the signed token descriptor.
+ * @param[in] dataLength Length of the data buffer.
+ * @param[in,out] flags Pointer to flags for APDU processing (currently unused).
+ * @param[in,out] tx Pointer to the outgoing APDU buffer size (currently unused).
+ */
+void handleProvideTokenInfo(uint8_t p1, uint8_t p2, uint8_t workBuffer[static 255],
+                            uint16_t dataLength,
+                            volatile unsigned int flags[static 1],
+                            volatile unsigned int tx[static 1])
+{
+    UNUSED(flags);
+    UNUSED(tx);
+
+    if ((p1 != 0) || (p2 != 0)) {
+        THROW(HW_INCORRECT_P1_P2);
+    }
+    switch (token_cache_provide(workBuffer, dataLength)) {
+    case TOKEN_INFO_OK:
+        THROW(HW_OK);
+    case TOKEN_INFO_FULL:
+        THROW(HW_NOT_ENOUGH_MEMORY_SPACE);
+    default:
+        THROW(HW_INCORRECT_DATA);
+    }
+}
+#endif
+
+#ifdef HAVE_VET_TRACE
+/**
+ * @brief Sends back a page of the event trace, for debugging builds (TRACE=1).
+ *
+ * @details The events are read oldest first, TRACE_RECORDS_PER_PAGE records per page, and can
+ * be decoded with tests/trace_decode.py.
+ *
+ * @param[in] p1 Instruction parameter 1 (P1), page to read.
+ * @param[in] p2 Instruction parameter 2 (P2), 1 to clear the trace after reading it.
+ * @param[in] workBuffer Pointer to the data buffer (currently unused).
+ * @param[in] dataLength Length of the data buffer (currently unused).
+ * @param[in,out] flags Pointer to flags for APDU processing (currently unused).
+ * @param[in,out] tx Pointer to the outgoing APDU buffer size.
+ */
+void handleGetTrace(uint8_t p1, uint8_t p2, uint8_t workBuffer[static 255],
+                    uint16_t dataLength,
+                    volatile unsigned int flags[static 1],
+                    volatile unsigned int tx[static 1])
+{
+    UNUSED(workBuffer);
+    UNUSED(dataLength);
+    UNUSED(flags);
+
+    if (p2 > 1) {
+        THROW(HW_INCORRECT_P1_P2);
+    }
+    *tx = vet_trace_dump(p1, G_io_apdu_buffer, sizeof(G_io_apdu_buffer) - 2);
+    if (p2 == 1) {
+        vet_trace_clear();
+    }
+    THROW(HW_OK);
+}
+#endif
+
+/**
+ * @brief Tells whether the review of a transaction is on screen while the host sends its next blocks.
+ */
+static bool review_streaming(void)
+{
+#ifdef HAVE_NBGL
+    return ui_stream_review_started();
+#else
+    return clauseReview.active && !clauseReview.complete;
+#endif
+}
+
+/**
+ * @brief Tells whether an APDU would replace the screen or start another signing session.
+ *
+ * @param[in] ins Instruction of the APDU.
+ * @param[in] p1 P1 of the APDU.
+ */
+static bool ins_takes_screen(uint8_t ins, uint8_t p1)
+{
+    return ((ins == INS_GET_PUBLIC_KEY) && (p1 == P1_CONFIRM)) || (ins == INS_SIGN_PERSONAL_MESSAGE) ||
+           (ins == INS_SIGN_CERTIFICATE) || (ins == INS_ADDRESS_BOOK);
+}
+
 /**
  * @brief Handles incoming APDU commands and delegates them to instruction handler based on (INS).
  *
@@ -1490,6 +3943,18 @@ void handleApdu(volatile unsigned int flags[static 1], volatile unsigned int tx[
 {
     unsigned short sw = 0;
 
+    stats_apdu_start(G_io_apdu_buffer[OFFSET_INS], G_io_apdu_buffer[OFFSET_LC]);
+
+    // A new command ends any review, drop the signature computed for it
+    speculative_sign_wipe();
+    // Any signing command but the next signatures of an approved batch discards the batch,
+    // queries do not
+    if (is_sign_ins(G_io_apdu_buffer[OFFSET_INS]) &&
+        ((G_io_apdu_buffer[OFFSET_INS] != INS_SIGN) ||
+         (G_io_apdu_buffer[OFFSET_P1] != P1_NEXT_SIGNATURES))) {
+        memset(&signatureBatch, 0, sizeof(signatureBatch));
+    }
+
     BEGIN_TRY {
         TRY {
             // Check if the class of the APDU command is supported.
@@ -1497,7 +3962,12 @@ void handleApdu(volatile unsigned int flags[static 1], volatile unsigned int tx[
                 THROW(HW_CLA_NOT_SUPPORTED);
             }
 
-            PRINTF("New APDU received:\n%.*H\n", G_io_apdu_buffer[OFFSET_LC] + OFFSET_LC, G_io_apdu_buffer);
+            TRACE(TRACE_APDU, G_io_apdu_buffer[OFFSET_INS], G_io_apdu_buffer[OFFSET_LC]);
+
+            // The review of a transaction being streamed keeps the screen until the user answers it
+            if (review_streaming() && ins_takes_screen(G_io_apdu_buffer[OFFSET_INS], G_io_apdu_buffer[OFFSET_P1])) {
+                THROW(HW_SW_TRANSACTION_CANCELLED);
+            }
 
             // Handle different APDU instructions based on their INS (Instruction) field.
             switch (G_io_apdu_buffer[OFFSET_INS]) {
@@ -1536,6 +4006,45 @@ void handleApdu(volatile unsigned int flags[static 1], volatile unsigned int tx[
                     G_io_apdu_buffer[OFFSET_LC], flags, tx);
                 break;
 
+            case INS_GET_LAST_RESPONSE:
+                handleGetLastResponse(
+                    G_io_apdu_buffer[OFFSET_P1], G_io_apdu_buffer[OFFSET_P2],
+                    G_io_apdu_buffer + OFFSET_CDATA,
+                    G_io_apdu_buffer[OFFSET_LC], flags, tx);
+                break;
+
+            case INS_GET_STATS:
+                handleGetStats(
+                    G_io_apdu_buffer[OFFSET_P1], G_io_apdu_buffer[OFFSET_P2],
+                    G_io_apdu_buffer + OFFSET_CDATA,
+                    G_io_apdu_buffer[OFFSET_LC], flags, tx);
+                break;
+
+            case INS_ADDRESS_BOOK:
+                handleAddressBook(
+                    G_io_apdu_buffer[OFFSET_P1], G_io_apdu_buffer[OFFSET_P2],
+                    G_io_apdu_buffer + OFFSET_CDATA,
+                    G_io_apdu_buffer[OFFSET_LC], flags, tx);
+                break;
+
+#ifdef TOKEN_SIGNER_PUBKEY
+            case INS_PROVIDE_TOKEN_INFO:
+                handleProvideTokenInfo(
+                    G_io_apdu_buffer[OFFSET_P1], G_io_apdu_buffer[OFFSET_P2],
+                    G_io_apdu_buffer + OFFSET_CDATA,
+                    G_io_apdu_buffer[OFFSET_LC], flags, tx);
+                break;
+#endif
+
+#ifdef HAVE_VET_TRACE
+            case INS_GET_TRACE:
+                handleGetTrace(
+                    G_io_apdu_buffer[OFFSET_P1], G_io_apdu_buffer[OFFSET_P2],
+                    G_io_apdu_buffer + OFFSET_CDATA,
+                    G_io_apdu_buffer[OFFSET_LC], flags, tx);
+                break;
+#endif
+
             default:
                 THROW(HW_INS_NOT_SUPPORTED);
                 break;
@@ -1547,9 +4056,17 @@ void handleApdu(volatile unsigned int flags[static 1], volatile unsigned int tx[
         CATCH_OTHER(e) {
             switch (e & ERROR_TYPE_MASK) {
             case ERROR_TYPE_HW:
-                // Wipe the transaction context and report the exception
+                // Only an error of the signing session itself ends it, then report the exception
                 sw = e;
-                memset(&displayContext, 0, sizeof(displayContext));
+                if (G_io_apdu_buffer[OFFSET_INS] == signSessionOwner) {
+                    sign_session_end();
+                    // A transaction under review cannot be signed any more
+#ifdef HAVE_NBGL
+                    ui_stream_review_abort();
+#else
+                    clause_review_abort();
+#endif
+                }
                 break;
             case HW_OK:
                 // All is well
@@ -1569,6 +4086,13 @@ void handleApdu(volatile unsigned int flags[static 1], volatile unsigned int tx[
         }
     }
     END_TRY;
+
+    TRACE(TRACE_APDU_DONE, 0, sw);
+
+    // The reply of a reviewed request is counted when the user answers
+    if (!(*flags & IO_ASYNCH_REPLY)) {
+        stats_apdu_reply(sw, *tx);
+    }
 }
 
 /**
@@ -1623,9 +4147,9 @@ void sample_main(void) {
             CATCH_OTHER(e) {
                 switch (e & ERROR_TYPE_MASK) {
                 case ERROR_TYPE_HW:
-                    // Wipe the transaction context and report the exception
+                    // Wipe the signing session and report the exception
                     sw = e;
-                    memset(&displayContext, 0, sizeof(displayContext));
+                    sign_session_end();
                     break;
                 case HW_OK:
                     // All is well
@@ -1719,6 +4243,14 @@ unsigned char io_event(unsigned char channel) {
         break;
 
     case SEPROXYHAL_TAG_TICKER_EVENT:
+        // Use the idle time of the review to compute the signature
+        if (speculativeSignature.pending) {
+            speculative_sign_run();
+        }
+        // Do not keep a signature once the device is locked
+        if (lastResponse.valid && (os_global_pin_is_validated() != BOLOS_UX_OK)) {
+            last_response_wipe();
+        }
         UX_TICKER_EVENT(G_io_seproxyhal_spi_buffer, {
             if (UX_ALLOWED) {
                 if (skipDataWarning && (ux_step == 0)) {
@@ -1752,9 +4284,12 @@ unsigned char io_event(unsigned char channel) {
  * @brief Exits the application, terminating its execution.
  *
  * @details This function exits the application, terminating its execution. It follows these steps:
+ * - Wipes any speculative signature still held in RAM.
  * - Calls os_sched_exit to terminate the application with a specified exit code (-1).
  */
 void app_exit(void) {
+    speculative_sign_wipe();
+    last_response_wipe();
     BEGIN_TRY_L(exit) {
         TRY_L(exit) {
             os_sched_exit(-1);
@@ -1789,6 +4324,9 @@ __attribute__((section(".boot"))) int main(void) {
     // Initialize the display context.
     memset(&displayContext, 0, sizeof(displayContext));
 
+    // Measure the stack high-water mark from now on
+    stats_stack_paint();
+
     // ensure exception will work as planned
     os_boot();
 
@@ -1806,6 +4344,7 @@ __attribute__((section(".boot"))) int main(void) {
                     internalStorage_t storage;
                     storage.dataAllowed = 0x00; // CONFIG_DATA_ENABLED;
                     storage.multiClauseAllowed = 0x00; // CONFIG_MULTICLAUSE_ENABLED;
+                    storage.expertMode = 0x00; // CONFIG_EXPERT_MODE_ENABLED;
                                                  storage.initialized = 0x01;
                     nvm_write((void *)&N_storage, &storage, sizeof(internalStorage_t));
                 }
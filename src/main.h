@@ -4,6 +4,7 @@
 typedef struct internalStorage_t {
     uint8_t dataAllowed;
     uint8_t multiClauseAllowed;
+    uint8_t expertMode;
     uint8_t initialized;
 } internalStorage_t;
 
@@ -13,16 +14,60 @@ extern const internalStorage_t N_storage_real;
 void ui_idle(void);
 
 extern volatile char fullAddress[43];
-extern volatile char fullAmount[50];
+/* Pages of the expert review of the data of a clause: selector, length, the words kept
+   and the hash of the whole data */
+#define CALLDATA_PAGES_MAX (2 + CLAUSE_DATA_WORDS + 1)
+// A word or the hash in hex
+#define CALLDATA_TEXT_LENGTH (2 * 32 + 1)
+
+extern volatile char fullAmount[CALLDATA_TEXT_LENGTH];
 extern volatile char maxFee[60];
 extern volatile bool dataPresent;
 extern volatile bool multipleClauses;
+extern volatile bool multipleSigners;
+extern volatile char reviewSubtitle[20];
+
+/* Values of the transaction review, formatted when their screen is first displayed */
+typedef enum reviewValue_e {
+    REVIEW_VALUE_ADDRESS,
+    REVIEW_VALUE_AMOUNT,
+    REVIEW_VALUE_FEE,
+} reviewValue_e;
+
+const char *review_value(reviewValue_e value);
+
+/* Assets totaled over the clauses of a transaction, VET and the well known tokens */
+#define REVIEW_TOTALS_MAX 4
+
+uint8_t review_totals_count(void);
+void review_total_format(uint8_t index, char *out);
+
+/* Distinct recipients of a sequence of transactions, a longer list being rejected */
+#define SEQUENCE_RECIPIENTS_MAX 8
+
+uint8_t review_recipients_count(void);
+void review_recipient_format(uint8_t index, char *out);
+
+uint8_t calldata_page_count(const clauseData_t *data);
+void calldata_page_format(const clauseData_t *data, uint8_t page, char *title, size_t titleSize, char *text);
+const clauseData_t *review_calldata(void);
+
+const char *message_preview(void);
+const certificateContent_t *certificate_content(void);
+
+const char *address_book_entry_label(void);
+bool address_book_entry_removed(void);
 
 
 unsigned int io_seproxyhal_touch_settings();
 unsigned int io_seproxyhal_touch_exit();
 unsigned int io_seproxyhal_touch_tx_ok();
 unsigned int io_seproxyhal_touch_address_ok();
+unsigned int io_seproxyhal_touch_address_book_ok();
 unsigned int io_seproxyhal_touch_cancel();
+#ifdef HAVE_NBGL
+unsigned int io_seproxyhal_touch_stream_continue(void);
+unsigned int io_seproxyhal_touch_stream_cancel(bool replyPending);
+#endif
 
 #endif
@@ -0,0 +1,200 @@
+/*******************************************************************************
+*   Ledger Blue
+*   (c) 2016 Ledger
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#include <string.h>
+#include "stats.h"
+#include "vetProfile.h"
+
+static const uint8_t STATS_INS[STATS_SLOTS - 1] = STATS_INS_LIST;
+
+// Pattern of the unused stack
+#define STACK_PAINT 0xA5A5A5A5
+// Words left untouched at the bottom of the stack, where the OS checks its canary
+#define STACK_PAINT_SKIP 8
+
+// Bounds of the stack, from the link script
+extern unsigned int _stack;
+extern unsigned int _estack;
+
+static insStats_t stats[STATS_SLOTS];
+
+// APDU being processed, its reply may be sent later by the review
+static insStats_t *current;
+
+static insStats_t *stats_slot(uint8_t ins) {
+    uint8_t i;
+    for (i = 0; i < STATS_SLOTS - 1; i++) {
+        if (STATS_INS[i] == ins) {
+            return &stats[i];
+        }
+    }
+    return &stats[STATS_SLOTS - 1];
+}
+
+static void write_u32(uint8_t *out, uint32_t value) {
+    out[0] = value >> 24;
+    out[1] = value >> 16;
+    out[2] = value >> 8;
+    out[3] = value;
+}
+
+/**
+ * @brief Clears all the counters.
+ */
+void stats_reset(void) {
+    uint8_t i;
+    memset(stats, 0, sizeof(stats));
+    for (i = 0; i < STATS_SLOTS - 1; i++) {
+        stats[i].ins = STATS_INS[i];
+    }
+    stats[STATS_SLOTS - 1].ins = STATS_INS_OTHER;
+    current = NULL;
+}
+
+/**
+ * @brief Resets the counters of a page.
+ *
+ * @details Resetting the memory page paints the stack again, so that the next read gives
+ * the high-water mark of the requests sent in between. Resetting the profile page clears
+ * the stage breakdown, the instruction counters are kept.
+ *
+ * @param[in] page Page to reset.
+ */
+void stats_reset_page(uint8_t page) {
+    if (page == STATS_PAGE_MEMORY) {
+        stats_stack_paint();
+    } else if (page == STATS_PAGE_PROFILE) {
+        PROFILE_RESET();
+    } else {
+        stats_reset();
+    }
+}
+
+/**
+ * @brief Fills the unused part of the stack with a known pattern.
+ *
+ * @details Called at startup. Only the part below the frame of this function is painted,
+ * without calling any other function.
+ */
+void stats_stack_paint(void) {
+    volatile unsigned int marker = 0;
+    volatile unsigned int *p = &_stack + STACK_PAINT_SKIP;
+    // Keep a margin below the current frame
+    volatile unsigned int *top = &marker - 16;
+
+    while (p < top) {
+        *p++ = STACK_PAINT;
+    }
+}
+
+/**
+ * @brief Measures the stack high-water mark since the stack was painted.
+ *
+ * @return The number of bytes of stack used at most.
+ */
+uint32_t stats_stack_used(void) {
+    const unsigned int *p = &_stack + STACK_PAINT_SKIP;
+
+    while ((p < &_estack) && (*p == STACK_PAINT)) {
+        p++;
+    }
+    return (uint32_t) ((uintptr_t) &_estack - (uintptr_t) p);
+}
+
+/**
+ * @brief Counts a received APDU.
+ *
+ * @param[in] ins Instruction of the APDU.
+ * @param[in] dataLength Length of the data of the APDU.
+ */
+void stats_apdu_start(uint8_t ins, uint8_t dataLength) {
+    if (stats[0].ins == 0) {
+        stats_reset();
+    }
+    current = stats_slot(ins);
+    current->calls++;
+    current->bytesIn += dataLength;
+}
+
+/**
+ * @brief Counts the reply of the current APDU, sent by the handler or after the review.
+ *
+ * @param[in] sw Status word of the reply.
+ * @param[in] tx Length of the reply, status word included.
+ */
+void stats_apdu_reply(uint16_t sw, uint32_t tx) {
+    if (current == NULL) {
+        return;
+    }
+    current->bytesOut += tx;
+    if (sw != 0x9000) {
+        current->errors++;
+        current->lastError = sw;
+    }
+    current = NULL;
+}
+
+/**
+ * @brief Serializes a page of counters.
+ *
+ * @details The STATS_PAGE_INS page contains, for each slot, the instruction, the last error
+ * status word, then the number of calls, bytes in, bytes out and number of errors, all
+ * big endian. The STATS_PAGE_PROFILE page contains the stage breakdown of the last request,
+ * see vet_profile_dump(). The STATS_PAGE_MEMORY page contains the size of the stack and its
+ * high-water mark, in bytes.
+ *
+ * @param[in] page Page to serialize.
+ * @param[out] out Output buffer.
+ * @param[in] outLength Size of the output buffer.
+ *
+ * @return The size of the page, 0 if the page does not exist or does not fit.
+ */
+uint32_t stats_write_page(uint8_t page, uint8_t *out, uint32_t outLength) {
+    uint32_t tx = 0;
+    uint8_t i;
+
+    if (stats[0].ins == 0) {
+        stats_reset();
+    }
+#ifdef HAVE_VET_PROFILE
+    if (page == STATS_PAGE_PROFILE) {
+        return vet_profile_dump(out, outLength);
+    }
+#endif
+    if (page == STATS_PAGE_MEMORY) {
+        if (outLength < STATS_MEMORY_LENGTH) {
+            return 0;
+        }
+        write_u32(out, (uint32_t) ((uintptr_t) &_estack - (uintptr_t) &_stack));
+        write_u32(out + 4, stats_stack_used());
+        return STATS_MEMORY_LENGTH;
+    }
+    if ((page != STATS_PAGE_INS) || (outLength < STATS_SLOTS * STATS_INS_RECORD_LENGTH)) {
+        return 0;
+    }
+    for (i = 0; i < STATS_SLOTS; i++) {
+        out[tx++] = stats[i].ins;
+        out[tx++] = stats[i].lastError >> 8;
+        out[tx++] = stats[i].lastError;
+        write_u32(out + tx, stats[i].calls);
+        write_u32(out + tx + 4, stats[i].bytesIn);
+        write_u32(out + tx + 8, stats[i].bytesOut);
+        write_u32(out + tx + 12, stats[i].errors);
+        tx += 16;
+    }
+    return tx;
+}
@@ -0,0 +1,57 @@
+/*******************************************************************************
+*   Ledger Blue
+*   (c) 2016 Ledger
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#ifndef _STATS_H_
+#define _STATS_H_
+
+#include "os.h"
+
+// Instructions with their own counters, any other one is counted in the last slot
+#define STATS_INS_LIST {0x02, 0x04, 0x06, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E}
+#define STATS_SLOTS 11
+#define STATS_INS_OTHER 0xFF
+
+// Pages of INS_GET_STATS
+#define STATS_PAGE_INS 0x00
+// Only in PROFILE=1 builds
+#define STATS_PAGE_PROFILE 0x01
+#define STATS_PAGE_MEMORY 0x02
+
+// Size of the memory page: stack size and stack high-water mark
+#define STATS_MEMORY_LENGTH (2 * 4)
+
+typedef struct insStats_t {
+    uint8_t ins;
+    uint16_t lastError;
+    uint32_t calls;
+    uint32_t bytesIn;
+    uint32_t bytesOut;
+    uint32_t errors;
+} insStats_t;
+
+// Size of the serialized counters of an instruction
+#define STATS_INS_RECORD_LENGTH (1 + 2 + 4 * 4)
+
+void stats_reset(void);
+void stats_reset_page(uint8_t page);
+void stats_stack_paint(void);
+uint32_t stats_stack_used(void);
+void stats_apdu_start(uint8_t ins, uint8_t dataLength);
+void stats_apdu_reply(uint16_t sw, uint32_t tx);
+uint32_t stats_write_page(uint8_t page, uint8_t *out, uint32_t outLength);
+
+#endif
@@ -0,0 +1,139 @@
+/*******************************************************************************
+*   Ledger Blue
+*   (c) 2016 Ledger
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#include <string.h>
+#include "cx.h"
+#include "tokenCache.h"
+#include "vetUtils.h"
+
+#ifdef TOKEN_SIGNER_PUBKEY
+// Open addressed by the hash of the token address, a slot is used once its ticker is set
+static tokenDefinition_t tokenCache[TOKEN_CACHE_SLOTS];
+
+static const uint8_t TOKEN_SIGNER_KEY[65] = TOKEN_SIGNER_PUBKEY;
+
+/**
+ * @brief Probes the slots of a token address, from the slot given by its hash.
+ *
+ * @return The slot of the token or the empty slot ending the probe sequence, or
+ * TOKEN_CACHE_SLOTS when the cache is full and the token is not in it.
+ */
+static uint8_t token_cache_find(const uint8_t *address)
+{
+    uint8_t slot = addressHash(address) & (TOKEN_CACHE_SLOTS - 1);
+    uint8_t probes;
+
+    for (probes = 0; probes < TOKEN_CACHE_SLOTS; probes++) {
+        if ((tokenCache[slot].ticker[0] == '\0') ||
+            (memcmp(tokenCache[slot].address, address, 20) == 0)) {
+            return slot;
+        }
+        slot = (slot + 1) & (TOKEN_CACHE_SLOTS - 1);
+    }
+    return TOKEN_CACHE_SLOTS;
+}
+
+/**
+ * @brief Looks for a token provided with PROVIDE_TOKEN_INFO.
+ *
+ * @param[in] address Address of the token contract.
+ *
+ * @return The token definition, or NULL if the token has not been provided.
+ */
+const tokenDefinition_t *token_cache_lookup(const uint8_t address[static 20])
+{
+    uint8_t slot = token_cache_find(address);
+
+    if ((slot == TOKEN_CACHE_SLOTS) || (tokenCache[slot].ticker[0] == '\0')) {
+        return NULL;
+    }
+    return &tokenCache[slot];
+}
+
+/**
+ * @brief Verifies a signed token descriptor and adds its token to the cache.
+ *
+ * @details The descriptor is the length of the ticker (1 byte), the ticker, the address of the
+ * token contract (20 bytes) and its decimals (1 byte), followed by the DER signature by
+ * TOKEN_SIGNER_PUBKEY of the SHA-256 hash of TOKEN_DESCRIPTOR_TAG and the descriptor. A token
+ * already provided is given its new definition.
+ *
+ * @param[in] data Signed descriptor.
+ * @param[in] length Length of the signed descriptor.
+ *
+ * @return TOKEN_INFO_INVALID if the descriptor is malformed or not signed by the trusted key,
+ * TOKEN_INFO_FULL if the token is new and the cache is full.
+ */
+tokenInfoStatus_e token_cache_provide(const uint8_t *data, uint16_t length)
+{
+    cx_ecfp_public_key_t signerKey;
+    cx_sha256_t sha256;
+    uint8_t hash[32];
+    uint16_t descriptorLength;
+    uint8_t tickerLength;
+    uint8_t slot;
+    uint8_t i;
+
+    if (length < 1) {
+        return TOKEN_INFO_INVALID;
+    }
+    tickerLength = data[0];
+    descriptorLength = 1 + tickerLength + 20 + 1;
+    if ((tickerLength == 0) || (tickerLength > MAX_TICKER_LENGTH) || (length <= descriptorLength)) {
+        return TOKEN_INFO_INVALID;
+    }
+    for (i = 0; i < tickerLength; i++) {
+        if ((data[1 + i] <= 0x20) || (data[1 + i] > 0x7E)) {
+            return TOKEN_INFO_INVALID;
+        }
+    }
+    if (data[descriptorLength - 1] > MAX_TOKEN_DECIMALS) {
+        return TOKEN_INFO_INVALID;
+    }
+
+    if ((cx_sha256_init_no_throw(&sha256) != CX_OK) ||
+        (cx_hash_no_throw((cx_hash_t *)&sha256, 0, (const uint8_t *)TOKEN_DESCRIPTOR_TAG,
+                          sizeof(TOKEN_DESCRIPTOR_TAG) - 1, NULL, 0) != CX_OK) ||
+        (cx_hash_no_throw((cx_hash_t *)&sha256, CX_LAST, data, descriptorLength, hash, sizeof(hash)) != CX_OK) ||
+        (cx_ecfp_init_public_key_no_throw(CX_CURVE_256K1, TOKEN_SIGNER_KEY, sizeof(TOKEN_SIGNER_KEY),
+                                          &signerKey) != CX_OK) ||
+        !cx_ecdsa_verify_no_throw(&signerKey, hash, sizeof(hash), data + descriptorLength,
+                                  length - descriptorLength)) {
+        return TOKEN_INFO_INVALID;
+    }
+
+    slot = token_cache_find(data + 1 + tickerLength);
+    if (slot == TOKEN_CACHE_SLOTS) {
+        return TOKEN_INFO_FULL;
+    }
+    memset(&tokenCache[slot], 0, sizeof(tokenDefinition_t));
+    memmove(tokenCache[slot].address, data + 1 + tickerLength, 20);
+    tokenCache[slot].decimals = data[descriptorLength - 1];
+    memmove(tokenCache[slot].ticker, data + 1, tickerLength);
+    tokenCache[slot].ticker[tickerLength] = ' ';
+    return TOKEN_INFO_OK;
+}
+#else
+/**
+ * @brief Builds without a trusted key are never provided any token.
+ */
+const tokenDefinition_t *token_cache_lookup(const uint8_t address[static 20])
+{
+    UNUSED(address);
+    return NULL;
+}
+#endif
@@ -0,0 +1,57 @@
+/*******************************************************************************
+*   Ledger Blue
+*   (c) 2016 Ledger
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#ifndef _TOKEN_CACHE_H_
+#define _TOKEN_CACHE_H_
+
+#include "os.h"
+#include <stdbool.h>
+#include "tokens.h"
+
+/* Uncompressed secp256k1 key signing the token descriptors of PROVIDE_TOKEN_INFO. Release
+   builds set the TOKEN_SIGNER_PUBKEY variable of the Makefile to the key of the token list,
+   TOKEN_TEST_KEY=1 builds trust the key of tests/test_provide_token_info_cmd.py. The
+   instruction is not supported by the builds without a key. */
+#ifdef HAVE_TOKEN_TEST_KEY
+#define TOKEN_SIGNER_PUBKEY                                                                   \
+    {0x04, 0x23, 0xf2, 0xab, 0xdf, 0x3e, 0x97, 0x27, 0xe7, 0x68, 0x10, 0x4a, 0x02,            \
+     0x81, 0xe2, 0x3d, 0xcf, 0x41, 0x3e, 0xfe, 0x8c, 0x6d, 0xc0, 0x56, 0x9a, 0x43,            \
+     0x6c, 0xfb, 0x66, 0xdc, 0x14, 0xd1, 0x4e, 0x80, 0x21, 0x96, 0xca, 0x89, 0xa1,            \
+     0xe4, 0xe9, 0xaa, 0x1f, 0xd0, 0xf7, 0xc1, 0x70, 0x21, 0x31, 0xd6, 0x2b, 0x23,            \
+     0xf5, 0xe3, 0xa0, 0x7b, 0x73, 0xa4, 0xfe, 0x42, 0xe5, 0x1f, 0x0a, 0x56, 0xd7}
+#endif
+
+// Hashed ahead of a token descriptor, so that its signature is not valid for another message
+#define TOKEN_DESCRIPTOR_TAG "VeChain token descriptor"
+
+// Tokens provided since the application started, the cache is never evicted
+#define TOKEN_CACHE_SLOTS 8
+// Decimals of a provided token, enough for any amount to be displayed
+#define MAX_TOKEN_DECIMALS 32
+
+typedef enum tokenInfoStatus_e {
+    TOKEN_INFO_OK,
+    TOKEN_INFO_INVALID,
+    TOKEN_INFO_FULL
+} tokenInfoStatus_e;
+
+const tokenDefinition_t *token_cache_lookup(const uint8_t address[static 20]);
+#ifdef TOKEN_SIGNER_PUBKEY
+tokenInfoStatus_e token_cache_provide(const uint8_t *data, uint16_t length);
+#endif
+
+#endif
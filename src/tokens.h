@@ -16,14 +16,22 @@
 *  limitations under the License.
 ********************************************************************************/
 
+#ifndef _TOKENS_H_
+#define _TOKENS_H_
+
 #include "os.h"
 
+// Characters of a ticker, stored followed by a space
+#define MAX_TICKER_LENGTH 10
+
 typedef struct tokenDefinition_t {
     uint8_t address[20];
-    uint8_t ticker[6];
+    uint8_t ticker[MAX_TICKER_LENGTH + 2];
     uint8_t decimals;
 } tokenDefinition_t;
 
-#define NUM_TOKENS 7
+/* Well known tokens, tokens.c being generated from tokens/tokens.csv by tokens/gen_tokens.py
+   with a minimal perfect hash of their address */
+const tokenDefinition_t *token_lookup(const uint8_t address[static 20]);
 
-extern tokenDefinition_t const TOKENS[NUM_TOKENS];
+#endif
@@ -22,6 +22,8 @@
 #include "glyphs.h"
 #include "nbgl_use_case.h"
 
+#include "vetClauseUstream.h"
+#include "vetCertificateUstream.h"
 #include "ui_nbgl.h"
 #include "main.h"
 enum
@@ -59,13 +61,15 @@ static const char *const INFO_CONTENTS[SETTING_INFO_NB] = {APPVERSION, "Vechain
 enum
 {
     CONTRACT_DATA_SWITCH_TOKEN = FIRST_USER_TOKEN,
-    MULTI_CLAUSE_SWITCH_TOKEN
+    MULTI_CLAUSE_SWITCH_TOKEN,
+    EXPERT_MODE_SWITCH_TOKEN
 };
 
 enum 
 {
     CONTRACT_DATA_SWITCH_ID = 0,
     MULTI_CLAUSE_SWITCH_ID, 
+    EXPERT_MODE_SWITCH_ID,
     SETTINGS_SWITCHES_NB
 };
 
@@ -113,6 +117,14 @@ static void controls_callback(int token, uint8_t index, int page)
         // store the new setting value in NVM
         nvm_write((void *)&N_storage.multiClauseAllowed, &switch_value, 1);
     }
+    else if (token == EXPERT_MODE_SWITCH_TOKEN)
+    {
+        // Expert mode switch touched
+        switch_value = !N_storage.expertMode;
+        switches[EXPERT_MODE_SWITCH_ID].initState = (nbgl_state_t)switch_value;
+        // store the new setting value in NVM
+        nvm_write((void *)&N_storage.expertMode, &switch_value, 1);
+    }
 }
 
 // home page defintion
@@ -129,6 +141,12 @@ void ui_menu_main(void)
     switches[MULTI_CLAUSE_SWITCH_ID].subText = "Allow multi-clauses\nin transactions";
     switches[MULTI_CLAUSE_SWITCH_ID].token = MULTI_CLAUSE_SWITCH_TOKEN;
     switches[MULTI_CLAUSE_SWITCH_ID].tuneId = TUNE_TAP_CASUAL;
+
+    switches[EXPERT_MODE_SWITCH_ID].initState = (nbgl_state_t)N_storage.expertMode;
+    switches[EXPERT_MODE_SWITCH_ID].text = "Expert mode";
+    switches[EXPERT_MODE_SWITCH_ID].subText = "Review contract data\nin hex";
+    switches[EXPERT_MODE_SWITCH_ID].token = EXPERT_MODE_SWITCH_TOKEN;
+    switches[EXPERT_MODE_SWITCH_ID].tuneId = TUNE_TAP_CASUAL;
     nbgl_useCaseHomeAndSettings(APPNAME,
                                 &C_stax_app_vechain_64px,
                                 NULL,
@@ -162,13 +180,103 @@ void ui_display_public_key_flow() {
                               ui_display_public_key_done);
 }
 
+//  -----------------------------------------------------------
+//  -------------------- ADDRESS BOOK FLOW --------------------
+//  -----------------------------------------------------------
+
+static nbgl_layoutTagValue_t address_book_pairs[2];
+static nbgl_layoutTagValueList_t address_book_pair_list = {0};
+
+static void ui_display_address_book_done(bool confirm) {
+    if (confirm) {
+        io_seproxyhal_touch_address_book_ok();
+        nbgl_useCaseStatus("Address book updated", true, ui_menu_main);
+    } else {
+        io_seproxyhal_touch_cancel();
+        nbgl_useCaseStatus("Address book unchanged", false, ui_menu_main);
+    }
+}
+
+void ui_display_address_book_flow() {
+    bool removed = address_book_entry_removed();
+
+    address_book_pairs[0].item = "Label";
+    address_book_pairs[0].value = address_book_entry_label();
+    address_book_pairs[1].item = "Address";
+    address_book_pairs[1].value = (const char *)fullAddress;
+
+    address_book_pair_list.nbMaxLinesForValue = 0;
+    address_book_pair_list.nbPairs = 2;
+    address_book_pair_list.pairs = address_book_pairs;
+
+    nbgl_useCaseReview(TYPE_OPERATION,
+                       &address_book_pair_list,
+                       &C_stax_app_vechain_64px,
+                       removed ? "Remove from address book" : "Add to address book",
+                       NULL,
+                       removed ? "Remove address" : "Add address",
+                       ui_display_address_book_done);
+}
+
 //  -----------------------------------------------------------
 //  ---------------- SIGN TRANSACTION FLOW --------------------
 //  -----------------------------------------------------------
 
-#define MAX_TAG_VALUE_PAIRS_DISPLAYED (3)
+#define TX_TAG_VALUE_PAIRS (3 + REVIEW_TOTALS_MAX + 1 + CALLDATA_PAGES_MAX)
+#define SEQUENCE_TAG_VALUE_PAIRS (3 + SEQUENCE_RECIPIENTS_MAX + REVIEW_TOTALS_MAX + 1)
+#define MAX_TAG_VALUE_PAIRS_DISPLAYED \
+    (TX_TAG_VALUE_PAIRS > SEQUENCE_TAG_VALUE_PAIRS ? TX_TAG_VALUE_PAIRS : SEQUENCE_TAG_VALUE_PAIRS)
 static nbgl_layoutTagValue_t pairs[MAX_TAG_VALUE_PAIRS_DISPLAYED];
 static nbgl_layoutTagValueList_t pair_list = {0};
+// Values of the pairs following the totals, formatted by review_value() when their page is displayed
+static reviewValue_e pair_values[MAX_TAG_VALUE_PAIRS_DISPLAYED];
+// Totals per asset of a transaction with multiple clauses, ahead of the other pairs
+static uint8_t pair_totals;
+static char total_texts[REVIEW_TOTALS_MAX + 1][50];
+// Pages of the data of the clause on screen in expert mode, following the other pairs
+static uint8_t pair_calldata;
+static char calldata_titles[CALLDATA_PAGES_MAX][16];
+static char calldata_texts[CALLDATA_PAGES_MAX][CALLDATA_TEXT_LENGTH];
+// Recipients of a sequence of transactions
+static char recipient_texts[SEQUENCE_RECIPIENTS_MAX][43];
+
+static nbgl_contentTagValue_t *review_pair_get(uint8_t index)
+{
+    if (index < pair_totals) {
+        review_total_format(index, total_texts[index]);
+        pairs[index].value = total_texts[index];
+    } else if (index < pair_calldata) {
+        pairs[index].value = review_value(pair_values[index]);
+    }
+    return &pairs[index];
+}
+
+// Add the pages of the data of a clause, returning the number of pairs added
+static uint8_t calldata_pairs(nbgl_layoutTagValue_t *dataPairs, const clauseData_t *data)
+{
+    uint8_t count = calldata_page_count(data);
+    uint8_t i;
+
+    for (i = 0; i < count; i++) {
+        calldata_page_format(data, i, calldata_titles[i], sizeof(calldata_titles[i]), calldata_texts[i]);
+        dataPairs[i].item = calldata_titles[i];
+        dataPairs[i].value = calldata_texts[i];
+    }
+    return count;
+}
+
+// Add the totals per asset ahead of the other pairs, returning the index of the next pair
+static uint8_t review_totals_pairs(nbgl_layoutTagValue_t *totalPairs)
+{
+    uint8_t count = review_totals_count();
+    uint8_t i;
+
+    for (i = 0; i < count; i++) {
+        totalPairs[i].item = "Total";
+    }
+    return count;
+}
+
 static void ui_display_action_sign_done(bool confirm)
 {
     if (confirm) {
@@ -181,24 +289,32 @@ static void ui_display_action_sign_done(bool confirm)
 }
 
 void ui_display_tx(){
-    pairs[0].item = "Amount";
-    pairs[0].value = (const char *)fullAmount;
-    pairs[1].item = "Fees";
-    pairs[1].value = (const char *)maxFee;
-    pairs[2].item = "To";
-    pairs[2].value = (const char *)fullAddress;
+    uint8_t i = review_totals_pairs(pairs);
+
+    pair_totals = i;
+    pairs[i].item = "Amount";
+    pair_values[i++] = REVIEW_VALUE_AMOUNT;
+    pairs[i].item = "Fees";
+    pair_values[i++] = REVIEW_VALUE_FEE;
+    pairs[i].item = "To";
+    pair_values[i++] = REVIEW_VALUE_ADDRESS;
+    pair_calldata = i;
+    if (review_calldata() != NULL) {
+        i += calldata_pairs(&pairs[i], review_calldata());
+    }
 
     // Setup list
     pair_list.nbMaxLinesForValue = 0;
-    pair_list.nbPairs = MAX_TAG_VALUE_PAIRS_DISPLAYED;
-    pair_list.pairs = pairs;
+    pair_list.nbPairs = i;
+    pair_list.pairs = NULL;
+    pair_list.callback = review_pair_get;
 
     // Start review
     nbgl_useCaseReview(TYPE_TRANSACTION,
                        &pair_list,
                        &C_stax_app_vechain_64px,
                        "Review transaction",
-                       NULL,
+                       multipleSigners ? (const char *)reviewSubtitle : NULL,
                        "Sign transaction",
                        ui_display_action_sign_done);
 }
@@ -210,40 +326,380 @@ static void review_warning_choice(bool confirm) {
     }
 }
 static const char *warning_msg;
-void ui_display_action_sign_tx_flow(){
+// Display the data and multiple clauses warning, if any, and ask the user to confirm it
+static bool review_warning_show(nbgl_choiceCallback_t choice_callback) {
     if(!dataPresent && !multipleClauses) {
-        ui_display_tx();
+        return false;
+    }
+
+    // prepare the warning message 
+    if(dataPresent && !multipleClauses)
+    {
+        warning_msg = "Data is present in\nthis transaction";
+    }
+    else if(!dataPresent && multipleClauses)
+    {
+        warning_msg = "Multiple clauses are\npresent in this\ntransaction";
     }
     else
     {
-        // prepare the warning message 
-        if(dataPresent && !multipleClauses)
-        {
-            warning_msg = "Data is present in\nthis transaction";
+        warning_msg = "Multiple clauses and\ndata are present in\nthis transaction";
+    }
+
+    nbgl_useCaseChoice(&C_Warning_64px,
+                       warning_msg,
+                       NULL,
+                       "I understand, confirm", "Cancel",
+                       choice_callback);
+    return true;
+}
+void ui_display_action_sign_tx_flow(){
+    if(!review_warning_show(review_warning_choice)) {
+        ui_display_tx();
+    }
+}
+
+//  -----------------------------------------------------------
+//  ------------- STREAMED TRANSACTION REVIEW -----------------
+//  -----------------------------------------------------------
+
+// Clauses parsed and not reviewed yet, the first one being on screen. Once it is full, the
+// parser is suspended and the reply of the data block waits until the user reviews a clause.
+#define STREAM_QUEUE_LENGTH (12)
+// The fees page, or a clause with the pages of its data in expert mode
+#define STREAM_FEES_PAIRS (2 + REVIEW_TOTALS_MAX + 1)
+#define STREAM_CLAUSE_PAIRS (3 + CALLDATA_PAGES_MAX)
+#define STREAM_MAX_TAG_VALUE_PAIRS_DISPLAYED \
+    (STREAM_FEES_PAIRS > STREAM_CLAUSE_PAIRS ? STREAM_FEES_PAIRS : STREAM_CLAUSE_PAIRS)
+
+typedef struct streamClause_t {
+    char index[6];
+    char address[43];
+    char amount[50];
+    bool data;
+    // Kept in expert mode only
+    clauseData_t calldata;
+} streamClause_t;
+
+typedef enum streamScreen_e {
+    STREAM_NONE = 0,    // review not started
+    STREAM_LOADING,     // waiting for the first clause, nothing reviewed yet
+    STREAM_WARNING,     // data and multiple clauses warning
+    STREAM_INTRO,       // first page of the review
+    STREAM_CLAUSE,      // first clause of the queue
+    STREAM_FEES,        // fees, once the transaction is complete
+    STREAM_WAITING      // waiting for the next clause
+} streamScreen_e;
+
+static struct {
+    streamScreen_e screen;
+    // The last block has been parsed, its reply waits for the approval
+    bool complete;
+    // The parser waits for room in the queue, and so does the reply of its block
+    bool replyHeld;
+    uint8_t head;
+    uint8_t count;
+    streamClause_t queue[STREAM_QUEUE_LENGTH];
+} stream;
+
+static nbgl_layoutTagValue_t stream_pairs[STREAM_MAX_TAG_VALUE_PAIRS_DISPLAYED];
+static nbgl_layoutTagValueList_t stream_pair_list = {0};
+
+static void stream_review_choice(bool confirm);
+static void stream_review_next(void);
+static void stream_review_wait(void);
+
+// Waiting for the next clause, the user may reject the transaction or check again
+static void stream_wait_choice(bool confirm)
+{
+    if (!confirm) {
+        stream_review_choice(false);
+    } else if (stream.screen == STREAM_WAITING) {
+        stream_review_next();
+    } else {
+        // No clause has been parsed yet
+        stream_review_wait();
+    }
+}
+
+static void stream_review_wait(void)
+{
+    nbgl_useCaseChoice(NULL,
+                       "Loading transaction",
+                       "Waiting for the next clauses",
+                       "Continue", "Reject transaction",
+                       stream_wait_choice);
+}
+
+static void stream_review_done(bool confirm)
+{
+    ui_stream_review_reset();
+    ui_display_action_sign_done(confirm);
+}
+
+static void stream_review_show(uint8_t nbPairs)
+{
+    stream_pair_list.nbMaxLinesForValue = 0;
+    stream_pair_list.nbPairs = nbPairs;
+    stream_pair_list.pairs = stream_pairs;
+    nbgl_useCaseReviewStreamingContinue(&stream_pair_list, stream_review_choice);
+}
+
+// Display the first queued clause, the fees or the final page, depending on what has been parsed
+static void stream_review_next(void)
+{
+    uint8_t nbPairs = 0;
+    uint8_t i;
+
+    if (stream.count != 0) {
+        streamClause_t *clause = &stream.queue[stream.head];
+        stream_pairs[nbPairs].item = "Clause";
+        stream_pairs[nbPairs++].value = clause->index;
+        stream_pairs[nbPairs].item = "Amount";
+        stream_pairs[nbPairs++].value = clause->amount;
+        stream_pairs[nbPairs].item = "To";
+        stream_pairs[nbPairs++].value = clause->address;
+        if (clause->data && N_storage.expertMode) {
+            nbPairs += calldata_pairs(&stream_pairs[nbPairs], &clause->calldata);
+        } else if (clause->data) {
+            stream_pairs[nbPairs].item = "Data";
+            stream_pairs[nbPairs++].value = "Present";
+        }
+        stream.screen = STREAM_CLAUSE;
+        stream_review_show(nbPairs);
+    } else if (stream.complete && (stream.screen != STREAM_FEES)) {
+        nbPairs = review_totals_pairs(stream_pairs);
+        for (i = 0; i < nbPairs; i++) {
+            review_total_format(i, total_texts[i]);
+            stream_pairs[i].value = total_texts[i];
         }
-        else if(!dataPresent && multipleClauses)
-        {
-            warning_msg = "Multiple clauses are\npresent in this\ntransaction";
+        stream_pairs[nbPairs].item = "Fees";
+        stream_pairs[nbPairs++].value = review_value(REVIEW_VALUE_FEE);
+        stream.screen = STREAM_FEES;
+        stream_review_show(nbPairs);
+    } else if (stream.complete) {
+        nbgl_useCaseReviewStreamingFinish("Sign transaction", stream_review_done);
+    } else {
+        stream.screen = STREAM_WAITING;
+        stream_review_wait();
+    }
+}
+
+static void stream_review_choice(bool confirm)
+{
+    if (!confirm) {
+        bool replyPending = stream.replyHeld || stream.complete;
+        ui_stream_review_reset();
+        io_seproxyhal_touch_stream_cancel(replyPending);
+        nbgl_useCaseReviewStatus(STATUS_TYPE_TRANSACTION_REJECTED, ui_menu_main);
+        return;
+    }
+    if (stream.screen == STREAM_CLAUSE) {
+        // The clause on screen has been reviewed
+        stream.head = (stream.head + 1) % STREAM_QUEUE_LENGTH;
+        stream.count--;
+    }
+    if (stream.replyHeld && (stream.count < STREAM_QUEUE_LENGTH)) {
+        // Parse the rest of the data block, now that the queue has room
+        stream.replyHeld = false;
+        io_seproxyhal_touch_stream_continue();
+        if (stream.screen == STREAM_NONE) {
+            // The parser has rejected the transaction
+            return;
         }
-        else
-        {
-            warning_msg = "Multiple clauses and\ndata are present in\nthis transaction";
+    }
+    stream_review_next();
+}
+
+void ui_stream_review_reset(void)
+{
+    memset(&stream, 0, sizeof(stream));
+}
+
+static void stream_review_intro(void)
+{
+    stream.screen = STREAM_INTRO;
+    nbgl_useCaseReviewStreamingStart(TYPE_TRANSACTION,
+                                     &C_stax_app_vechain_64px,
+                                     "Review transaction",
+                                     multipleSigners ? (const char *)reviewSubtitle : NULL,
+                                     stream_review_choice);
+}
+
+static void stream_warning_choice(bool confirm)
+{
+    if (confirm) {
+        stream_review_intro();
+    } else {
+        stream_review_choice(false);
+    }
+}
+
+void ui_stream_review_start(void)
+{
+    if ((stream.screen != STREAM_NONE) && (stream.screen != STREAM_LOADING)) {
+        return;
+    }
+    if (stream.count == 0) {
+        // The warning is only known once the first clause has been parsed
+        if (stream.screen == STREAM_NONE) {
+            stream.screen = STREAM_LOADING;
+            stream_review_wait();
         }
+        return;
+    }
+    stream.screen = STREAM_WARNING;
+    if (!review_warning_show(stream_warning_choice)) {
+        stream_review_intro();
+    }
+}
 
-        // Display the warning message and ask the user to confirm
-        nbgl_useCaseChoice(&C_Warning_64px,
-                           warning_msg,
-                           NULL,
-                           "I understand, confirm", "Cancel",
-                           review_warning_choice);
+bool ui_stream_review_started(void)
+{
+    return stream.screen != STREAM_NONE;
+}
+
+void ui_stream_review_clause(uint16_t index, const char *address, const char *amount, const clauseData_t *data)
+{
+    streamClause_t *clause;
+
+    clause = &stream.queue[(stream.head + stream.count) % STREAM_QUEUE_LENGTH];
+    snprintf(clause->index, sizeof(clause->index), "%d", index + 1);
+    snprintf(clause->address, sizeof(clause->address), "%s", address);
+    snprintf(clause->amount, sizeof(clause->amount), "%s", amount);
+    clause->data = (data != NULL);
+    if ((data != NULL) && N_storage.expertMode) {
+        // The data of the clause is overwritten by the next clause, before the user reaches it
+        memmove(&clause->calldata, data, sizeof(clauseData_t));
+    }
+    stream.count++;
+    if (stream.screen == STREAM_WAITING) {
+        stream_review_next();
+    }
+}
+
+bool ui_stream_review_full(void)
+{
+    return stream.count == STREAM_QUEUE_LENGTH;
+}
+
+void ui_stream_review_hold(void)
+{
+    stream.replyHeld = true;
+}
+
+void ui_stream_review_finish(void)
+{
+    if (stream.screen == STREAM_LOADING) {
+        // Nothing has been reviewed yet, the whole transaction is reviewed at once
+        ui_stream_review_reset();
+        ui_display_action_sign_tx_flow();
+        return;
+    }
+    stream.complete = true;
+    if (stream.screen == STREAM_WAITING) {
+        stream_review_next();
     }
 }
 
+void ui_stream_review_abort(void)
+{
+    if (stream.screen != STREAM_NONE) {
+        ui_stream_review_reset();
+        ui_menu_main();
+    }
+}
+
+void ui_display_action_sign_delegation_flow(){
+    pair_totals = 0;
+    pair_calldata = 2;
+    pairs[0].item = "Gas payer for";
+    pair_values[0] = REVIEW_VALUE_ADDRESS;
+    pairs[1].item = "Fees";
+    pair_values[1] = REVIEW_VALUE_FEE;
+
+    // Setup list
+    pair_list.nbMaxLinesForValue = 0;
+    pair_list.nbPairs = 2;
+    pair_list.pairs = NULL;
+    pair_list.callback = review_pair_get;
+
+    // Start review
+    nbgl_useCaseReview(TYPE_TRANSACTION,
+                       &pair_list,
+                       &C_stax_app_vechain_64px,
+                       "Review gas payment",
+                       NULL,
+                       "Sign gas payment",
+                       ui_display_action_sign_done);
+}
+
+static void ui_display_sequence(void){
+    uint8_t recipients = review_recipients_count();
+    uint8_t totals = review_totals_count();
+    uint8_t nbPairs = 0;
+    uint8_t i;
+
+    pairs[nbPairs].item = "Transactions";
+    pairs[nbPairs++].value = (const char *)fullAmount;
+    pairs[nbPairs].item = "From";
+    pairs[nbPairs++].value = (const char *)fullAddress;
+    // Every recipient of the sequence, then the totals per asset
+    for (i = 0; i < recipients; i++) {
+        review_recipient_format(i, recipient_texts[i]);
+        pairs[nbPairs].item = "To";
+        pairs[nbPairs++].value = recipient_texts[i];
+    }
+    for (i = 0; i < totals; i++) {
+        review_total_format(i, total_texts[i]);
+        pairs[nbPairs].item = "Total";
+        pairs[nbPairs++].value = total_texts[i];
+    }
+    pairs[nbPairs].item = "Total fees";
+    pairs[nbPairs++].value = (const char *)maxFee;
+
+    // Setup list
+    pair_list.nbMaxLinesForValue = 0;
+    pair_list.nbPairs = nbPairs;
+    pair_list.pairs = pairs;
+    pair_list.callback = NULL;
+
+    // Start review
+    nbgl_useCaseReview(TYPE_TRANSACTION,
+                       &pair_list,
+                       &C_stax_app_vechain_64px,
+                       "Review transactions",
+                       (const char *)reviewSubtitle,
+                       "Sign transactions",
+                       ui_display_action_sign_done);
+}
+
+static void review_sequence_warning_choice(bool confirm) {
+    if (confirm) {
+        ui_display_sequence();
+    } else {
+        ui_display_action_sign_done(false);
+    }
+}
+
+void ui_display_action_sign_sequence_flow(){
+    if (!dataPresent) {
+        ui_display_sequence();
+        return;
+    }
+    // The contract calls of the sequence are only reviewed through their recipient
+    nbgl_useCaseChoice(&C_Warning_64px,
+                       "Data is present in\nthese transactions",
+                       NULL,
+                       "I understand, confirm", "Cancel",
+                       review_sequence_warning_choice);
+}
+
 //  ----------------------------------------------------------- 
 //  --------------- SIGN MSG/CERTIFICATE FLOW -----------------
 //  ----------------------------------------------------------- 
 
-#define MSG_CERT_MAX_TAG_VALUE_PAIRS_DISPLAYED (1)
+#define MSG_CERT_MAX_TAG_VALUE_PAIRS_DISPLAYED (7)
 static nbgl_layoutTagValue_t msg_cert_pairs[MSG_CERT_MAX_TAG_VALUE_PAIRS_DISPLAYED];
 static nbgl_layoutTagValueList_t msg_cert_pair_list = {0};
 
@@ -296,11 +752,20 @@ void ui_display_action_sign_msg_cert(transactionType_t p_transaction_type)
 {
     msg_cert_pairs[0].value = (const char *)fullAddress;
     msg_cert_pair_list.nbMaxLinesForValue = 0;
-    msg_cert_pair_list.nbPairs = MSG_CERT_MAX_TAG_VALUE_PAIRS_DISPLAYED;
+    msg_cert_pair_list.nbPairs = 1;
     msg_cert_pair_list.pairs = msg_cert_pairs;
 
     if(p_transaction_type == MSG_TRANSACTION) {
-        msg_cert_pairs[0].item = "Message hash";
+        if (message_preview()[0] != '\0') {
+            // The leading bytes of the message, then its hash
+            msg_cert_pairs[0].item = "Message";
+            msg_cert_pairs[0].value = message_preview();
+            msg_cert_pairs[1].item = "Message hash";
+            msg_cert_pairs[1].value = (const char *)fullAddress;
+            msg_cert_pair_list.nbPairs = 2;
+        } else {
+            msg_cert_pairs[0].item = "Message hash";
+        }
         nbgl_useCaseReview(TYPE_MESSAGE,
                            &msg_cert_pair_list,
                            &C_stax_app_vechain_64px,
@@ -310,7 +775,25 @@ void ui_display_action_sign_msg_cert(transactionType_t p_transaction_type)
                            review_msg_choice);
     }
     else {
-        msg_cert_pairs[0].item = "Certificate hash";
+        const certificateContent_t *certificate = certificate_content();
+        uint8_t nbPairs = 0;
+
+        msg_cert_pairs[nbPairs].item = "Purpose";
+        msg_cert_pairs[nbPairs++].value = certificate->purpose;
+        msg_cert_pairs[nbPairs].item = "Domain";
+        msg_cert_pairs[nbPairs++].value = certificate->domain;
+        msg_cert_pairs[nbPairs].item = "Type";
+        msg_cert_pairs[nbPairs++].value = certificate->payloadType;
+        msg_cert_pairs[nbPairs].item = "Content";
+        msg_cert_pairs[nbPairs++].value = certificate->payloadContent;
+        msg_cert_pairs[nbPairs].item = "Timestamp";
+        msg_cert_pairs[nbPairs++].value = certificate->timestamp;
+        if (certificate->fields & CERT_FIELD_BIT(CERT_FIELD_SIGNER)) {
+            msg_cert_pairs[nbPairs].item = "Signer";
+            msg_cert_pairs[nbPairs++].value = certificate->signer;
+        }
+        msg_cert_pairs[nbPairs].item = "Certificate hash";
+        msg_cert_pairs[nbPairs++].value = (const char *)fullAddress;
 
         certificateContentsList[0].type = CENTERED_INFO;
         certificateContentsList[0].content.centeredInfo.text1 = "Review certificate";
@@ -320,7 +803,7 @@ void ui_display_action_sign_msg_cert(transactionType_t p_transaction_type)
 
         certificateContentsList[1].type = TAG_VALUE_LIST;
         certificateContentsList[1].content.tagValueList.pairs = msg_cert_pairs;
-        certificateContentsList[1].content.tagValueList.nbPairs = MSG_CERT_MAX_TAG_VALUE_PAIRS_DISPLAYED;
+        certificateContentsList[1].content.tagValueList.nbPairs = nbPairs;
         certificateContentsList[1].content.tagValueList.nbMaxLinesForValue = 0;
 
         certificateContentsList[2].type = INFO_LONG_PRESS;
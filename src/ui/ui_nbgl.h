@@ -25,11 +25,68 @@ void ui_menu_settings(void);
  */
 void ui_display_public_key_flow(void);
 
+/**
+ * Show the entry of the address book to add or remove.
+ */
+void ui_display_address_book_flow(void);
+
 /**
  * Show action sign transaction flow.
  */
 void ui_display_action_sign_tx_flow(void);
 
+/**
+ * Forget the clauses of the streamed review, without changing the screen.
+ */
+void ui_stream_review_reset(void);
+
+/**
+ * Start the streamed review of a transaction, if not started yet, with the data and multiple clauses warning.
+ * Until its first clause has been parsed, the review waits on a loading screen.
+ */
+void ui_stream_review_start(void);
+
+/**
+ * Tell whether the streamed review of the transaction has been started.
+ */
+bool ui_stream_review_started(void);
+
+/**
+ * Add a parsed clause to the streamed review, with its data when it is not a token transfer.
+ * The queue always has room for it, the parser being suspended once it is full.
+ */
+void ui_stream_review_clause(uint16_t index, const char *address, const char *amount, const clauseData_t *data);
+
+/**
+ * Tell whether the queue of the streamed review is full, no clause being parsed until the user reviews one.
+ */
+bool ui_stream_review_full(void);
+
+/**
+ * Hold the reply of the last data block, the parser being suspended until the user reviews a queued clause.
+ */
+void ui_stream_review_hold(void);
+
+/**
+ * End the streamed review with the fees, once the whole transaction has been parsed.
+ */
+void ui_stream_review_finish(void);
+
+/**
+ * Leave the streamed review after an error, back to the main menu.
+ */
+void ui_stream_review_abort(void);
+
+/**
+ * Show sign flow of the gas payer of a transaction.
+ */
+void ui_display_action_sign_delegation_flow(void);
+
+/**
+ * Show sign flow of a sequence of transactions chained by dependsOn.
+ */
+void ui_display_action_sign_sequence_flow(void);
+
 /**
  * Show message or certificate sign flow depending on "p_transaction_type" value.
  */
@@ -0,0 +1,110 @@
+import json
+import os
+import statistics
+from pathlib import Path
+from typing import Dict, List
+
+BENCHMARK_DIR = Path(__file__).parent.resolve()
+
+# Benchmarks are opt-in so that the functional CI run is not slowed down
+BENCHMARK_ENABLED = os.environ.get("VECHAIN_BENCHMARK", "0") == "1"
+# Number of times each measurement is repeated
+BENCHMARK_ROUNDS = int(os.environ.get("VECHAIN_BENCHMARK_ROUNDS", "5"))
+# Where the JSON report is written
+LATENCY_REPORT = Path(os.environ.get("VECHAIN_BENCHMARK_REPORT", "latency_report.json"))
+# Checked-in reference the report is compared against, none when set to an empty string
+LATENCY_BASELINE = os.environ.get("VECHAIN_BENCHMARK_BASELINE",
+                                  str(BENCHMARK_DIR / "latency_baseline.json"))
+# Allowed ratio between a measured median and its baseline, overrides the baseline file
+LATENCY_THRESHOLD = os.environ.get("VECHAIN_BENCHMARK_THRESHOLD")
+
+
+# Minimal RLP encoder, enough to build the transactions of the matrix
+def rlp_encode(item) -> bytes:
+    if isinstance(item, list):
+        payload = b"".join(rlp_encode(i) for i in item)
+        return _rlp_length(len(payload), 0xC0) + payload
+    if isinstance(item, int):
+        item = item.to_bytes((item.bit_length() + 7) // 8, "big")
+    if len(item) == 1 and item[0] < 0x80:
+        return item
+    return _rlp_length(len(item), 0x80) + item
+
+def _rlp_length(length: int, offset: int) -> bytes:
+    if length < 56:
+        return bytes([offset + length])
+    encoded = length.to_bytes((length.bit_length() + 7) // 8, "big")
+    return bytes([offset + 55 + len(encoded)]) + encoded
+
+
+# Builds a VeChain transaction with clause_count clauses carrying data_length bytes of data each,
+# with the given reserved features (1 for a transaction paid by a gas payer)
+def build_tx(clause_count: int, data_length: int, features: int = 0) -> bytes:
+    to = bytes.fromhex("d6fdbeb6d0fbc690dabd352cf93b2f8d782a46b5")
+    data = bytes((i * 7 + 1) & 0xFF for i in range(data_length))
+    clauses = [[to, 5 * 10**18, data] for _ in range(clause_count)]
+    return rlp_encode([
+        0xAA,                                   # chainTag
+        bytes.fromhex("abe47d18daa1301d"),      # blockRef
+        0x2D0,                                  # expiration
+        clauses,
+        128,                                    # gasPriceCoef
+        21000 * clause_count + 68 * data_length * clause_count,
+        b"",                                    # dependsOn
+        0x1234,                                 # nonce
+        [features] if features else []          # reserved
+    ])
+
+
+# Clauses waiting for the streamed review of Stax and Flex before the parser stops
+STREAM_QUEUE_LENGTH = 12
+
+
+# Tells whether every data block of a transaction with clause_count clauses is replied without
+# the user: Nano devices review each clause of a transaction with several clauses before
+# replying to its block, Stax and Flex once STREAM_QUEUE_LENGTH clauses wait for the review
+def replied_without_review(device: str, clause_count: int) -> bool:
+    if device.startswith("nano"):
+        return clause_count <= 1
+    return clause_count < STREAM_QUEUE_LENGTH
+
+
+def summarize(samples_ms: List[float]) -> Dict[str, float]:
+    ordered = sorted(samples_ms)
+    return {
+        "samples": len(ordered),
+        "median_ms": round(statistics.median(ordered), 3),
+        "p90_ms": round(ordered[min(len(ordered) - 1, (len(ordered) * 9) // 10)], 3),
+        "min_ms": round(ordered[0], 3),
+        "max_ms": round(ordered[-1], 3),
+    }
+
+
+def load_baseline() -> dict:
+    if not LATENCY_BASELINE or not Path(LATENCY_BASELINE).exists():
+        return {}
+    with open(LATENCY_BASELINE) as f:
+        return json.load(f)
+
+
+def threshold_for(baseline: dict, key: str, device: str) -> float:
+    if LATENCY_THRESHOLD is not None:
+        return float(LATENCY_THRESHOLD)
+    entry = baseline.get("devices", {}).get(device, {}).get(key, {})
+    return float(entry.get("threshold", baseline.get("threshold", 1.25)))
+
+
+# Returns a description of the regression, or None when the result is within the threshold
+# Without a baseline file nothing is checked, but a key missing from a baseline file fails
+def check_regression(baseline: dict, device: str, key: str, result: Dict[str, float]):
+    if not baseline:
+        return None
+    entry = baseline.get("devices", {}).get(device, {}).get(key)
+    if entry is None:
+        return f"{device} {key}: no baseline in {LATENCY_BASELINE}, record one from a reference " \
+               f"report or run with VECHAIN_BENCHMARK_BASELINE="
+    limit = entry["median_ms"] * threshold_for(baseline, key, device)
+    if result["median_ms"] > limit:
+        return f"{device} {key}: median {result['median_ms']} ms > {limit:.3f} ms " \
+               f"(baseline {entry['median_ms']} ms)"
+    return None
@@ -0,0 +1,16 @@
+import json
+import pytest
+from bench_utils import LATENCY_REPORT, load_baseline
+
+
+# Collects the results of all the latency benchmarks of the session
+# The report is written once at the end, with the same layout as the baseline:
+# { "devices": { "<device>": { "<key>": { "median_ms": ..., ... } } } }
+@pytest.fixture(scope="session")
+def latency_report():
+    report = {"baseline": load_baseline(), "devices": {}}
+    yield report
+    if report["devices"]:
+        LATENCY_REPORT.parent.mkdir(parents=True, exist_ok=True)
+        with open(LATENCY_REPORT, "w") as f:
+            json.dump({"devices": report["devices"]}, f, indent=2, sort_keys=True)
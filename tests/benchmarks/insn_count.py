@@ -0,0 +1,384 @@
+# Deterministic instruction counts of the application under Speculos
+#
+# Speculos is started with its GDB server (--debug) and every APDU of a fixed set of inputs is
+# sent through its REST API. A breakpoint on handleApdu() catches each APDU, which is then
+# single-stepped up to the return of handleApdu(). Every instruction executed in the
+# application text is counted and attributed to its function using the ELF symbols.
+#
+# The host side of syscalls (crypto, screen, NVM) runs outside the application text: it is
+# skipped at full speed and only the number of syscalls is reported, so the counts only
+# depend on the application code and its inputs and can be compared exactly between runs.
+# Only handleApdu() is measured: the signatures computed after an on-screen approval are
+# syscalls anyway. With the default settings, a transaction with data or several clauses is
+# rejected with 0x6A80 as soon as its first clause is parsed, and on Nano devices the clauses
+# are parsed from the review once the settings allow them. These inputs are therefore signed
+# by a gas payer: the same transaction is parsed and hashed within handleApdu() without the
+# settings and the clause review, which covers the whole parser on every model.
+#
+# With a PROFILE=1 build, the instructions and syscalls executed between the PROFILE_BEGIN()
+# and PROFILE_END() markers of common/vetProfile.h are also attributed to their stage: the
+# entries of vet_profile_begin() and vet_profile_end() are recognized while stepping and their
+# first argument gives the stage. A stage left by an exception stays open until the end of
+# the APDU.
+#
+# Usage: python3 insn_count.py bin/app.elf --model nanosp [--output insn_report.json]
+#                              [--baseline insn_baseline.json] [--tolerance 0]
+# Requires speculos and pyelftools (pip install speculos pyelftools)
+import argparse
+import bisect
+import json
+import socket
+import struct
+import subprocess
+import sys
+import threading
+import time
+import urllib.request
+from collections import Counter
+from typing import Optional
+from pathlib import Path
+from elftools.elf.elffile import ELFFile
+from elftools.elf.sections import SymbolTableSection
+
+sys.path.insert(0, str(Path(__file__).parent.parent.resolve()))
+from ragger.bip import pack_derivation_path
+from vechain_client import CLA, InsType, P1, P2, MAX_APDU_LEN, PROFILE_STAGES, split_message
+from bench_utils import build_tx
+
+SIGTRAP = 5
+
+# The path used for all inputs
+path: str = "m/44'/818'/0'/0/0"
+
+# Sender of the transactions signed by a gas payer
+ORIGIN = bytes.fromhex("d6fdbeb6d0fbc690dabd352cf93b2f8d782a46b5")
+
+MESSAGE = b"Hello Ledger !"
+CERTIFICATE = json.dumps({'purpose': 'identification', 'payload': {'type': 'text', 'content': 'fyi'},
+                          'domain': 'localhost', 'timestamp': 15035330},
+                         sort_keys=True, separators=(',', ':')).encode()
+
+
+def apdu(ins: int, p1: int, p2: int, data: bytes) -> bytes:
+    return bytes([CLA, ins, p1, p2, len(data)]) + data
+
+
+def chunked(ins: int, payload: bytes, p2: int = P2.P2_LAST) -> list:
+    chunks = split_message(payload, MAX_APDU_LEN)
+    return [apdu(ins, P1.P1_START if i == 0 else P2.P2_MORE, p2, chunk)
+            for i, chunk in enumerate(chunks)]
+
+
+# Fixed inputs: name -> list of APDUs
+def inputs() -> dict:
+    packed_path = pack_derivation_path(path)
+    return {
+        "get_app_configuration": [apdu(InsType.INS_GET_APP_CONFIGURATION, 0, 0, b"")],
+        "get_public_key": [apdu(InsType.INS_GET_PUBLIC_KEY, P1.P1_START, P2.P2_LAST, packed_path)],
+        "sign_tx_1_clause": chunked(InsType.INS_SIGN, packed_path + build_tx(1, 0)),
+        "sign_tx_delegation_4_clauses_64_data": chunked(InsType.INS_SIGN, packed_path + ORIGIN + build_tx(4, 64, 1),
+                                                        P2.P2_SIGN_DELEGATOR),
+        "sign_tx_delegation_16_clauses_512_data": chunked(InsType.INS_SIGN,
+                                                          packed_path + ORIGIN + build_tx(16, 512, 1),
+                                                          P2.P2_SIGN_DELEGATOR),
+        "sign_message": chunked(InsType.INS_SIGN_PERSONAL_MESSAGE,
+                                packed_path + struct.pack(">I", len(MESSAGE)) + MESSAGE),
+        "sign_certificate": chunked(InsType.INS_SIGN_CERTIFICATE,
+                                    packed_path + struct.pack(">I", len(CERTIFICATE)) + CERTIFICATE),
+    }
+
+
+class Symbols:
+    def __init__(self, elf: ELFFile, offset: int):
+        functions = []
+        for section in elf.iter_sections():
+            if not isinstance(section, SymbolTableSection):
+                continue
+            for symbol in section.iter_symbols():
+                if symbol["st_info"]["type"] == "STT_FUNC" and symbol["st_size"] > 0:
+                    functions.append(((symbol["st_value"] & ~1) + offset, symbol["st_size"], symbol.name))
+        functions.sort()
+        self.starts = [function[0] for function in functions]
+        self.functions = functions
+        segments = [segment for segment in elf.iter_segments()
+                    if segment["p_type"] == "PT_LOAD" and segment["p_flags"] & 1]
+        self.text_start = min(segment["p_vaddr"] for segment in segments) + offset
+        self.text_end = max(segment["p_vaddr"] + segment["p_memsz"] for segment in segments) + offset
+
+    def address(self, name: str) -> int:
+        return next(start for start, _, function in self.functions if function == name)
+
+    def find(self, name: str) -> Optional[int]:
+        return next((start for start, _, function in self.functions if function == name), None)
+
+    def lookup(self, pc: int) -> str:
+        index = bisect.bisect_right(self.starts, pc) - 1
+        if index >= 0:
+            start, size, name = self.functions[index]
+            if pc < start + size:
+                return name
+        return f"0x{pc:08x}"
+
+    def in_text(self, pc: int) -> bool:
+        return self.text_start <= pc < self.text_end
+
+
+# Minimal GDB remote serial protocol client, enough for breakpoints and single steps
+class GdbRemote:
+    def __init__(self, port: int, timeout: float = 30):
+        deadline = time.time() + timeout
+        while True:
+            try:
+                self.sock = socket.create_connection(("127.0.0.1", port))
+                break
+            except OSError:
+                if time.time() > deadline:
+                    raise
+                time.sleep(0.2)
+        self.buffer = b""
+        self.ack = True
+        if self.command("QStartNoAckMode") == "OK":
+            self.ack = False
+
+    def _read(self) -> int:
+        while not self.buffer:
+            data = self.sock.recv(4096)
+            if not data:
+                raise ConnectionError("GDB server closed the connection")
+            self.buffer += data
+        byte = self.buffer[0]
+        self.buffer = self.buffer[1:]
+        return byte
+
+    def send(self, payload: str):
+        checksum = sum(payload.encode()) & 0xFF
+        self.sock.sendall(f"${payload}#{checksum:02x}".encode())
+        if self.ack:
+            while self._read() != ord("+"):
+                pass
+
+    def receive(self) -> str:
+        while self._read() != ord("$"):
+            pass
+        payload = bytearray()
+        while (byte := self._read()) != ord("#"):
+            payload.append(byte)
+        self._read()
+        self._read()
+        if self.ack:
+            self.sock.sendall(b"+")
+        # Run-length encoding: "X*n" repeats X n - 29 more times
+        decoded = bytearray()
+        i = 0
+        while i < len(payload):
+            if payload[i] == ord("*"):
+                decoded += bytes([decoded[-1]]) * (payload[i + 1] - 29)
+                i += 2
+            else:
+                decoded.append(payload[i])
+                i += 1
+        return decoded.decode()
+
+    def command(self, payload: str) -> str:
+        self.send(payload)
+        return self.receive()
+
+    def register(self, number: int) -> int:
+        return struct.unpack("<I", bytes.fromhex(self.command(f"p{number:x}")))[0]
+
+    def pc(self) -> int:
+        return self.register(15)
+
+    def lr(self) -> int:
+        return self.register(14)
+
+    def read_u16(self, address: int) -> int:
+        return struct.unpack("<H", bytes.fromhex(self.command(f"m{address:x},2")))[0]
+
+    def set_breakpoint(self, address: int):
+        assert self.command(f"Z0,{address:x},2") == "OK"
+
+    def remove_breakpoint(self, address: int):
+        assert self.command(f"z0,{address:x},2") == "OK"
+
+    # Both return the signal of the stop reply
+    def resume(self, signal: int = 0) -> int:
+        self.send(f"C{signal:02x}" if signal else "c")
+        return self.stop_signal(self.receive())
+
+    def step(self, signal: int = 0) -> int:
+        self.send(f"S{signal:02x}" if signal else "s")
+        return self.stop_signal(self.receive())
+
+    @staticmethod
+    def stop_signal(reply: str) -> int:
+        if reply[0] in "WX":
+            raise ConnectionError(f"application exited ({reply})")
+        assert reply[0] in "ST", reply
+        return int(reply[1:3], 16)
+
+
+def thumb_size(gdb: GdbRemote, pc: int) -> int:
+    return 4 if (gdb.read_u16(pc) & 0xF800) in (0xE800, 0xF000, 0xF800) else 2
+
+
+def stage_name(stage: int) -> str:
+    return PROFILE_STAGES[stage] if stage < len(PROFILE_STAGES) else f"stage_{stage}"
+
+
+# Steps from the entry of handleApdu() up to its return, counting the application instructions
+def count_apdu(gdb: GdbRemote, symbols: Symbols) -> dict:
+    stop = gdb.lr() & ~1
+    begin = symbols.find("vet_profile_begin")
+    end = symbols.find("vet_profile_end")
+    functions = Counter()
+    stages = Counter()
+    # Open stages, innermost last
+    open_stages = []
+    syscalls = 0
+    pc = gdb.pc()
+    previous = pc
+    signal = 0
+    while pc != stop:
+        if pc == begin:
+            open_stages.append(stage_name(gdb.register(0)))
+        elif pc == end:
+            name = stage_name(gdb.register(0))
+            if name in open_stages:
+                del open_stages[len(open_stages) - 1 - open_stages[::-1].index(name):]
+        if symbols.in_text(pc):
+            functions[symbols.lookup(pc)] += 1
+            if open_stages:
+                stages[f"{open_stages[-1]}.instructions"] += 1
+            previous = pc
+            signal = gdb.step(signal)
+        else:
+            # Host side of a syscall: run it at full speed up to the next application instruction
+            syscalls += 1
+            if open_stages:
+                stages[f"{open_stages[-1]}.syscalls"] += 1
+            resume = previous + thumb_size(gdb, previous)
+            gdb.set_breakpoint(resume)
+            signal = gdb.resume(signal)
+            gdb.remove_breakpoint(resume)
+        if signal == SIGTRAP:
+            signal = 0
+        pc = gdb.pc()
+    return {"instructions": sum(functions.values()), "syscalls": syscalls, "functions": functions,
+            "stages": stages}
+
+
+def exchange(api_port: int, data: bytes, result: dict):
+    request = urllib.request.Request(f"http://127.0.0.1:{api_port}/apdu",
+                                     data=json.dumps({"data": data.hex()}).encode(),
+                                     headers={"Content-Type": "application/json"})
+    with urllib.request.urlopen(request) as response:
+        result["response"] = bytes.fromhex(json.load(response)["data"])
+
+
+def wait_api(api_port: int, timeout: float = 60):
+    deadline = time.time() + timeout
+    while True:
+        try:
+            urllib.request.urlopen(f"http://127.0.0.1:{api_port}/events", timeout=1).close()
+            return
+        except OSError:
+            if time.time() > deadline:
+                raise
+            time.sleep(0.5)
+
+
+def measure(args, symbols: Symbols) -> dict:
+    speculos = subprocess.Popen([args.speculos, args.elf, "--model", args.model, "--display", "headless",
+                                 "--debug", "--api-port", str(args.api_port)],
+                                stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+    try:
+        gdb = GdbRemote(args.gdb_port)
+        entry = symbols.address("handleApdu")
+        gdb.set_breakpoint(entry)
+        gdb.send("c")
+        wait_api(args.api_port)
+
+        report = {}
+        for name, apdus in inputs().items():
+            results = []
+            for data in apdus:
+                result = {}
+                thread = threading.Thread(target=exchange, args=(args.api_port, data, result))
+                thread.start()
+                assert GdbRemote.stop_signal(gdb.receive()) == SIGTRAP
+                gdb.remove_breakpoint(entry)
+                counts = count_apdu(gdb, symbols)
+                gdb.set_breakpoint(entry)
+                gdb.send("c")
+                # The last APDU of the signing inputs waits for the user, there is no response
+                thread.join(timeout=2)
+                if "response" in result:
+                    counts["sw"] = f"{int.from_bytes(result['response'][-2:], 'big'):04x}"
+                results.append(counts)
+            total = Counter()
+            stages = Counter()
+            for counts in results:
+                total.update(counts.pop("functions"))
+                stages.update(counts.pop("stages"))
+            report[name] = {
+                "apdus": results,
+                "instructions": sum(counts["instructions"] for counts in results),
+                "functions": dict(total.most_common(args.top)),
+                "stages": dict(sorted(stages.items())),
+            }
+        return report
+    finally:
+        speculos.kill()
+        speculos.wait()
+
+
+# Returns the inputs whose count moved by more than tolerance percents
+def compare(report: dict, baseline: dict, tolerance: float) -> list:
+    changes = []
+    for name, entry in report.items():
+        if name not in baseline:
+            continue
+        reference = baseline[name]["instructions"]
+        delta = entry["instructions"] - reference
+        if abs(delta) * 100 > tolerance * reference:
+            changes.append(f"{name}: {entry['instructions']} instructions ({delta:+d} vs {reference})")
+    return changes
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Instruction counts per APDU under Speculos")
+    parser.add_argument("elf", help="application ELF file, e.g. bin/app.elf")
+    parser.add_argument("--model", required=True, help="Speculos model: nanos, nanox, nanosp, stax, flex")
+    parser.add_argument("--speculos", default="speculos", help="Speculos command")
+    parser.add_argument("--api-port", type=int, default=5000)
+    parser.add_argument("--gdb-port", type=int, default=1234, help="port of the Speculos GDB server")
+    parser.add_argument("--load-offset", type=lambda v: int(v, 0), default=0,
+                        help="difference between the load and link addresses of the application")
+    parser.add_argument("--top", type=int, default=20, help="functions reported per input")
+    parser.add_argument("--output", default="insn_report.json")
+    parser.add_argument("--baseline", help="previous report to compare with")
+    parser.add_argument("--tolerance", type=float, default=0, help="allowed change, in percents")
+    args = parser.parse_args()
+
+    with open(args.elf, "rb") as f:
+        symbols = Symbols(ELFFile(f), args.load_offset)
+        report = measure(args, symbols)
+
+    with open(args.output, "w") as f:
+        json.dump(report, f, indent=2)
+    for name, entry in report.items():
+        print(f"{name:<32} {entry['instructions']:>10}")
+        for stage, count in entry["stages"].items():
+            print(f"    {stage:<28} {count:>10}")
+
+    if args.baseline:
+        with open(args.baseline) as f:
+            changes = compare(report, json.load(f), args.tolerance)
+        for change in changes:
+            print(change)
+        sys.exit(1 if changes else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,77 @@
+# Replay of a transaction corpus through the application under Speculos, run with:
+#   VECHAIN_BENCHMARK=1 pytest tests/benchmarks/test_corpus_replay_bench.py --device <device>
+# Environment, on top of the ones of test_latency_bench.py:
+#   VECHAIN_BENCHMARK_CORPUS     corpus to replay (default tests/corpus/seed.vtxc)
+#
+# Every transaction is streamed as INS_SIGN APDUs, except for its last byte: the final APDU
+# would wait for the on-screen review. Everything but that byte goes through the parser, so
+# the parser rejections are seen; the policy checks (data, clauses) done once the
+# transaction is complete are reported from the corpus metadata. The transactions whose
+# blocks wait for the clause review (several clauses on Nano, 12 clauses or more on Stax and
+# Flex) are not streamed and only counted.
+# The host-native replay of the same corpus is "make -C tests/native replay".
+import os
+import sys
+import time
+import pytest
+from pathlib import Path
+from ragger.backend import RaisePolicy
+from ragger.bip import pack_derivation_path
+from ragger.navigator import NavInsID, NavIns
+from utils import settingEnables
+from vechain_client import VechainClient, MAX_APDU_LEN, split_message
+from bench_utils import BENCHMARK_ENABLED, replied_without_review, summarize, check_regression
+
+sys.path.insert(0, str(Path(__file__).parent.parent.resolve() / "corpus"))
+import corpus
+
+pytestmark = pytest.mark.skipif(not BENCHMARK_ENABLED, reason="set VECHAIN_BENCHMARK=1 to run benchmarks")
+
+CORPUS = os.environ.get("VECHAIN_BENCHMARK_CORPUS",
+                        str(Path(__file__).parent.parent.resolve() / "corpus" / "seed.vtxc"))
+
+# The path used for all benchmarks
+path: str = "m/44'/818'/0'/0/0"
+
+
+def test_corpus_replay(firmware, backend, navigator, latency_report):
+    client = VechainClient(backend)
+    settingEnables(firmware.device, navigator.navigate, NavInsID, NavIns)
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+
+    latencies = []
+    total_bytes = 0
+    total_ms = 0.0
+    results = {"streamed": 0, "rejected": 0, "malformed": 0, "need_settings": 0, "need_review": 0}
+    for metadata, transaction in corpus.read(CORPUS):
+        if not replied_without_review(firmware.device, metadata.get("clauses", 0)):
+            results["need_review"] += 1
+            continue
+        if "malformed" in metadata:
+            results["malformed"] += 1
+        elif metadata["data_bytes"] != 0 or metadata["clauses"] > 1:
+            results["need_settings"] += 1
+
+        chunks = split_message(pack_derivation_path(path) + transaction[:-1], MAX_APDU_LEN)
+        elapsed = 0.0
+        rejected = False
+        for i, chunk in enumerate(chunks):
+            start = time.perf_counter()
+            rapdu = client.sign_tx_chunk(chunk, first=(i == 0))
+            elapsed += (time.perf_counter() - start) * 1000
+            if rapdu.status != 0x9000:
+                rejected = True
+                break
+        results["rejected" if rejected else "streamed"] += 1
+        latencies.append(elapsed)
+        total_bytes += len(transaction) - 1
+        total_ms += elapsed
+
+    assert latencies, f"{CORPUS} is empty"
+    result = summarize(latencies)
+    result.update(results)
+    result["throughput_kBps"] = round(total_bytes / total_ms, 3) if total_ms else 0
+    key = f"corpus/{Path(CORPUS).stem}"
+    latency_report["devices"].setdefault(firmware.device, {})[key] = result
+    regression = check_regression(latency_report["baseline"], firmware.device, key, result)
+    assert regression is None, regression
@@ -0,0 +1,90 @@
+# Wall-clock APDU round-trip benchmarks, run against Speculos with:
+#   VECHAIN_BENCHMARK=1 pytest tests/benchmarks --device <device>
+# Environment:
+#   VECHAIN_BENCHMARK_ROUNDS     repetitions of each measurement (default 5)
+#   VECHAIN_BENCHMARK_REPORT     JSON report to write (default latency_report.json)
+#   VECHAIN_BENCHMARK_BASELINE   baseline to compare with (default latency_baseline.json here),
+#                                empty to only write the report
+#   VECHAIN_BENCHMARK_THRESHOLD  allowed median/baseline ratio, overrides the baseline file
+# Every measurement must have an entry in the baseline file. To record or refresh it, run
+# with VECHAIN_BENCHMARK_BASELINE= on the reference setup and merge the "devices" of the
+# report into latency_baseline.json.
+#
+# Only the APDUs answered without user interaction are timed: the legs that wait for an
+# on-screen approval would mostly measure the emulated navigation. The transactions whose
+# blocks wait for the clause review (several clauses on Nano, 12 clauses or more on Stax and
+# Flex) are skipped for the same reason.
+import time
+import pytest
+from ragger.navigator import NavInsID, NavIns
+from utils import settingEnables
+from vechain_client import VechainClient, split_tx
+from bench_utils import BENCHMARK_ENABLED, BENCHMARK_ROUNDS, build_tx, replied_without_review, summarize, \
+    check_regression
+
+pytestmark = pytest.mark.skipif(not BENCHMARK_ENABLED, reason="set VECHAIN_BENCHMARK=1 to run benchmarks")
+
+# The path used for all benchmarks
+path: str = "m/44'/818'/0'/0/0"
+
+# Matrix of the INS_SIGN benchmark
+CLAUSE_COUNTS = [1, 4, 8]
+DATA_LENGTHS = [0, 64, 512]
+
+
+def timed_ms(call) -> float:
+    start = time.perf_counter()
+    call()
+    return (time.perf_counter() - start) * 1000
+
+
+def record(latency_report, device: str, key: str, samples, **params):
+    result = summarize(samples)
+    result.update(params)
+    latency_report["devices"].setdefault(device, {})[key] = result
+    regression = check_regression(latency_report["baseline"], device, key, result)
+    assert regression is None, regression
+
+
+def test_latency_get_app_configuration(firmware, backend, latency_report):
+    client = VechainClient(backend)
+    samples = [timed_ms(client.get_app_configuration) for _ in range(BENCHMARK_ROUNDS)]
+    record(latency_report, firmware.device, "INS_GET_APP_CONFIGURATION", samples)
+
+
+def test_latency_get_public_key(firmware, backend, latency_report):
+    client = VechainClient(backend)
+    samples = [timed_ms(lambda: client.get_public_key(path=path)) for _ in range(BENCHMARK_ROUNDS)]
+    record(latency_report, firmware.device, "INS_GET_PUBLIC_KEY", samples)
+
+
+# Times every chunk of a transaction but the last one, which waits for the review.
+# The next P1_FIRST chunk discards the pending transaction, so no navigation is needed.
+@pytest.mark.parametrize("data_length", DATA_LENGTHS)
+@pytest.mark.parametrize("clause_count", CLAUSE_COUNTS)
+def test_latency_sign_tx_chunks(firmware, backend, navigator, latency_report, clause_count, data_length):
+    if not replied_without_review(firmware.device, clause_count):
+        pytest.skip("the data blocks wait for the clause review")
+    client = VechainClient(backend)
+    # Data and multiple clauses must be allowed for the parser to go through the whole matrix
+    settingEnables(firmware.device, navigator.navigate, NavInsID, NavIns)
+
+    transaction = build_tx(clause_count, data_length)
+    chunks = split_tx(path, transaction)
+    if len(chunks) < 2:
+        pytest.skip("transaction fits in a single APDU")
+
+    chunk_samples = []
+    total_samples = []
+    for _ in range(BENCHMARK_ROUNDS):
+        total = 0.0
+        for i, chunk in enumerate(chunks[:-1]):
+            elapsed = timed_ms(lambda: client.sign_tx_chunk(chunk, first=(i == 0)))
+            chunk_samples.append(elapsed)
+            total += elapsed
+        total_samples.append(total)
+
+    key = f"INS_SIGN/clauses={clause_count}/data={data_length}"
+    params = {"tx_size": len(transaction), "chunks": len(chunks)}
+    record(latency_report, firmware.device, key + "/chunk", chunk_samples, **params)
+    record(latency_report, firmware.device, key + "/total", total_samples, **params)
@@ -0,0 +1,135 @@
+# Corpus of unsigned VeChain transactions, for the replay benchmarks
+#
+# A corpus file (.vtxc) is a sequence of length-prefixed records after a header:
+#   header: b"VTXC" then a version byte (1)
+#   record: metadata length (2 bytes, big endian), metadata (UTF-8 JSON object),
+#           transaction length (4 bytes, big endian), unsigned transaction RLP
+# The metadata describes the shape of the transaction (see shape()) and where it comes from.
+#
+# Corpora are built from text lists, one transaction per line: "<hex RLP> [source]",
+# "#" starting a comment. Real transactions can be exported from a Thor node with
+# the raw unsigned body of each transaction (without the signature field).
+#
+# Usage: python3 corpus.py build <list.txt> <corpus.vtxc>
+#        python3 corpus.py list <corpus.vtxc>
+import json
+import struct
+import sys
+from typing import Iterator, List, Tuple
+
+MAGIC = b"VTXC"
+VERSION = 1
+TOKEN_TRANSFER_ID = bytes.fromhex("a9059cbb")
+TOKEN_TRANSFER_DATA_LENGTH = 4 + 32 + 32
+
+
+def rlp_decode(data: bytes, offset: int = 0):
+    """Returns the decoded item at offset and the offset following it"""
+    prefix = data[offset]
+    if prefix < 0x80:
+        return data[offset:offset + 1], offset + 1
+    if prefix < 0xB8:
+        length = prefix - 0x80
+        return data[offset + 1:offset + 1 + length], offset + 1 + length
+    if prefix < 0xC0:
+        size = prefix - 0xB7
+        length = int.from_bytes(data[offset + 1:offset + 1 + size], "big")
+        start = offset + 1 + size
+        return data[start:start + length], start + length
+    if prefix < 0xF8:
+        start, length = offset + 1, prefix - 0xC0
+    else:
+        size = prefix - 0xF7
+        start = offset + 1 + size
+        length = int.from_bytes(data[offset + 1:start], "big")
+    items = []
+    position = start
+    while position < start + length:
+        item, position = rlp_decode(data, position)
+        items.append(item)
+    if position != start + length:
+        raise ValueError("inconsistent RLP list length")
+    return items, start + length
+
+
+def shape(transaction: bytes) -> dict:
+    body, end = rlp_decode(transaction)
+    if end != len(transaction):
+        raise ValueError("trailing bytes after the transaction")
+    _, _, _, clauses, _, _, depends_on, _, reserved = body
+    data_lengths = [len(clause[2]) for clause in clauses]
+    token_transfers = sum(1 for clause in clauses
+                          if len(clause[2]) == TOKEN_TRANSFER_DATA_LENGTH and clause[2][:4] == TOKEN_TRANSFER_ID)
+    features = int.from_bytes(reserved[0], "big") if reserved else 0
+    return {
+        "size": len(transaction),
+        "clauses": len(clauses),
+        "data_bytes": sum(data_lengths),
+        "max_data_bytes": max(data_lengths, default=0),
+        "max_value_bytes": max((len(clause[1]) for clause in clauses), default=0),
+        "token_transfers": token_transfers,
+        "contract_calls": sum(1 for length in data_lengths if length != 0) - token_transfers,
+        "depends_on": len(depends_on) != 0,
+        "features": features,
+    }
+
+
+def write(path: str, records: List[Tuple[dict, bytes]]):
+    with open(path, "wb") as f:
+        f.write(MAGIC + bytes([VERSION]))
+        for metadata, transaction in records:
+            encoded = json.dumps(metadata, sort_keys=True, separators=(",", ":")).encode()
+            f.write(struct.pack(">H", len(encoded)) + encoded)
+            f.write(struct.pack(">I", len(transaction)) + transaction)
+
+
+def read(path: str) -> Iterator[Tuple[dict, bytes]]:
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:4] != MAGIC or data[4] != VERSION:
+        raise ValueError(f"{path} is not a version {VERSION} corpus")
+    position = 5
+    while position < len(data):
+        (length,) = struct.unpack_from(">H", data, position)
+        metadata = json.loads(data[position + 2:position + 2 + length])
+        position += 2 + length
+        (length,) = struct.unpack_from(">I", data, position)
+        yield metadata, data[position + 4:position + 4 + length]
+        position += 4 + length
+
+
+def build(list_path: str, corpus_path: str):
+    records = []
+    with open(list_path) as f:
+        for number, line in enumerate(f, 1):
+            line = line.split("#", 1)[0].strip()
+            if not line:
+                continue
+            fields = line.split(maxsplit=1)
+            transaction = bytes.fromhex(fields[0])
+            try:
+                metadata = shape(transaction)
+            except ValueError as e:
+                # Kept, the replay reports how the application handles it
+                metadata = {"size": len(transaction), "malformed": str(e)}
+            except IndexError:
+                metadata = {"size": len(transaction), "malformed": "truncated RLP"}
+            metadata["source"] = fields[1] if len(fields) > 1 else f"{list_path}:{number}"
+            records.append((metadata, transaction))
+    write(corpus_path, records)
+    print(f"{len(records)} transactions written to {corpus_path}")
+
+
+def main():
+    if len(sys.argv) == 4 and sys.argv[1] == "build":
+        build(sys.argv[2], sys.argv[3])
+    elif len(sys.argv) == 3 and sys.argv[1] == "list":
+        for metadata, transaction in read(sys.argv[2]):
+            print(json.dumps(metadata, sort_keys=True))
+    else:
+        print("usage: corpus.py build <list.txt> <corpus.vtxc> | list <corpus.vtxc>")
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
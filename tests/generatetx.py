@@ -4,6 +4,9 @@ from thor_devkit import cry, transaction, rlp
 from thor_devkit.rlp import DictWrapper, HomoListWrapper, ComplexCodec, NumericKind, CompactFixedBlobKind, NoneableFixedBlobKind, BlobKind, BytesKind
 import random
 import argparse
+import json
+import sys
+from pathlib import Path
 from copy import deepcopy
 from enum import IntEnum
 
@@ -91,6 +94,159 @@ def randomHex(length, prefix=True):
         # ["a"]
         ) for i in range(0, int(length)*2)])
 
+
+# Sweep mode: families of valid unsigned transactions along one scaling axis, each sample
+# with its signing hash and the strings the application is expected to display.
+BASE_GAS_PRICE = 10**13
+DECIMALS_VET = 18
+ENERGY_ADDRESS = "0x0000000000000000000000000000456e65726779"
+UNKNOWN_TOKEN_ADDRESS = "0x0ce6661b4ba86a0ea7ca2bd86a0de87b0b860f15"
+RECIPIENT = "0xd6FdBEB6d0FBC690DaBD352cF93b2f8D782A46B5"
+TOKEN_TRANSFER_ID = "a9059cbb"
+
+SWEEPS = {
+    "clauses": [1, 2, 4, 8, 16, 32, 64, 128, 255, 256],
+    "calldata": [0, 1, 4, 68, 255, 256, 1024, 4096, 16384, 65536],
+    "value": list(range(1, 33)),
+    "token": ["VET", "VTHO", "unknown"],
+    "reserved": ["none", "delegation", "unknown-feature", "unused"],
+}
+
+# Mirrors adjustDecimals() of common/vetUtils.c
+def adjust_decimals(amount: int, decimals: int) -> str:
+    digits = str(amount)
+    if amount == 0 or decimals == 0:
+        return digits
+    if len(digits) <= decimals:
+        integer, fraction = "0", digits.rjust(decimals, "0")
+    else:
+        integer, fraction = digits[:-decimals], digits[-decimals:]
+    fraction = fraction.rstrip("0")
+    return integer + "." + fraction if fraction else integer
+
+def checksum_address(address: str) -> str:
+    import sha3
+    hex_address = address.lower().replace("0x", "")
+    digest = sha3.keccak_256(hex_address.encode()).hexdigest()
+    return "0x" + "".join(c.upper() if c.isalpha() and int(digest[i], 16) > 7 else c
+                          for i, c in enumerate(hex_address))
+
+# Mirrors maxFeeToDisplayString() of common/vetDisplay.c
+def max_fee(gas_price_coef: int, gas: int) -> int:
+    return ((gas_price_coef * BASE_GAS_PRICE) // 255 + BASE_GAS_PRICE) * gas
+
+def token_transfer_data(recipient: str, amount: int) -> str:
+    return "0x" + TOKEN_TRANSFER_ID + "00" * 12 + recipient.lower().replace("0x", "") + f"{amount:064x}"
+
+def token_transfer_amount(clause: dict):
+    data = clause["data"].replace("0x", "")
+    if data.startswith(TOKEN_TRANSFER_ID) and len(data) == 2 * 68 and clause["to"].lower() == ENERGY_ADDRESS:
+        return int(data[8 + 64:], 16)
+    return None
+
+# Mirrors asset_total_add() of src/main.c, VET being always the first total
+def expected_totals(clauses: list) -> list:
+    if len(clauses) <= 1:
+        return []
+    totals = {"VET ": 0}
+    for clause in clauses:
+        amount = token_transfer_amount(clause)
+        totals["VET "] += int(clause["value"])
+        if amount:
+            totals["VTHO "] = totals.get("VTHO ", 0) + amount
+    return [ticker + adjust_decimals(amount, DECIMALS_VET) for ticker, amount in totals.items()]
+
+# Mirrors calldata_page_format() of src/main.c: the pages of the expert review of some data
+CLAUSE_DATA_WINDOW = 4 + 3 * 32
+def expected_calldata(data: str) -> list:
+    data = bytes.fromhex(data)
+    total_words = (len(data) - 4 + 31) // 32 if len(data) > 4 else 0
+    window = data[:CLAUSE_DATA_WINDOW]
+    pages = [("Selector", "0x" + window[:4].hex().upper()), ("Data length", f"{len(data)} bytes")]
+    for i in range(4, len(window), 32):
+        pages.append((f"Word {(i - 4) // 32 + 1}/{total_words}", window[i:i + 32].hex().upper()))
+    pages.append(("Data hash", cry.blake2b256([data])[0].hex().upper()))
+    return pages
+
+def expected_display(body: dict) -> dict:
+    clause = body["clauses"][0]
+    data = clause["data"].replace("0x", "")
+    address, amount, ticker = clause["to"], int(clause["value"]), "VET "
+    data_present = any(len(c["data"].replace("0x", "")) != 0 for c in body["clauses"])
+    # Only the known tokens are decoded, see handleSign()
+    if data_present and data.startswith(TOKEN_TRANSFER_ID) and len(data) == 2 * 68 and \
+            clause["to"].lower() == ENERGY_ADDRESS:
+        data_present = False
+        address = "0x" + data[8 + 24:8 + 64]
+        amount = int(data[8 + 64:], 16)
+        ticker = "VTHO "
+    return {
+        "address": checksum_address(address),
+        "amount": ticker + adjust_decimals(amount, DECIMALS_VET),
+        "max_fee": "VTHO " + adjust_decimals(max_fee(body["gasPriceCoef"], body["gas"]), DECIMALS_VET),
+        "data_present": data_present,
+        "multiple_clauses": len(body["clauses"]) > 1,
+        "totals": expected_totals(body["clauses"]),
+        # Reviewed in expert mode only, for the first clause
+        "calldata": expected_calldata(data) if data_present and len(data) != 0 else [],
+    }
+
+def sweep_body(axis: str, step) -> dict:
+    clauses, data, value, to, reserved = 1, "0x", 5 * 10**18, RECIPIENT, None
+    if axis == "clauses":
+        clauses = step
+    elif axis == "calldata":
+        data = "0x" + "".join(f"{(i * 7 + 1) & 0xFF:02x}" for i in range(step))
+    elif axis == "value":
+        value = int.from_bytes(b"\x99" * step, "big")
+    elif axis == "token" and step != "VET":
+        to = ENERGY_ADDRESS if step == "VTHO" else UNKNOWN_TOKEN_ADDRESS
+        data, value = token_transfer_data(RECIPIENT, 12 * 10**18), 0
+    elif axis == "reserved":
+        reserved = {"none": None,
+                    "delegation": {"features": 1},
+                    "unknown-feature": {"features": 2},
+                    "unused": {"features": 1, "unused": [bytes.fromhex("01")]}}[step]
+    body = {
+        "chainTag": 0xAA,
+        "blockRef": "0xabe47d18daa1301d",
+        "expiration": 0x2D0,
+        "clauses": [{"to": to, "value": value, "data": data} for _ in range(clauses)],
+        "gasPriceCoef": 128,
+        "gas": 21000 * clauses + 68 * len(data) // 2 * clauses,
+        "dependsOn": None,
+        "nonce": 0x1234,
+    }
+    if reserved is not None:
+        body["reserved"] = reserved
+    return body
+
+def run_sweep(axes, output, corpus_path):
+    records = []
+    out = open(output, "w") if output else sys.stdout
+    for axis in axes:
+        for step in SWEEPS[axis]:
+            body = sweep_body(axis, step)
+            tx = transaction.Transaction(body)
+            encoded = tx.encode()
+            sample = {
+                "axis": axis,
+                "step": step,
+                "size": len(encoded),
+                "tx": encoded.hex(),
+                "signing_hash": tx.get_signing_hash().hex(),
+                "display": expected_display(body),
+            }
+            out.write(json.dumps(sample) + "\n")
+            records.append(({"source": f"generatetx.py --sweep {axis}", "step": step}, encoded))
+    if output:
+        out.close()
+    if corpus_path:
+        sys.path.insert(0, str(Path(__file__).parent.resolve() / "corpus"))
+        import corpus
+        corpus.write(corpus_path, [(dict(corpus.shape(encoded), **metadata), encoded)
+                                   for metadata, encoded in records])
+
 parser = argparse.ArgumentParser()
 parser.add_argument('--path', help="BIP 32 path to sign with")
 parser.add_argument('--chaintag', help="Chaintag")
@@ -109,9 +265,18 @@ parser.add_argument('--data', help="Data to add, hex encoded")
 parser.add_argument('--length', help="byte length of random data to add to each clause")
 parser.add_argument('--clauses', help="number of clauses")
 
+parser.add_argument('--sweep', nargs='+', choices=list(SWEEPS) + ["all"],
+                    help="generate families of transactions along these axes instead")
+parser.add_argument('--output', help="sweep mode: JSON lines file to write, stdout by default")
+parser.add_argument('--corpus', help="sweep mode: also write the transactions as a corpus (see corpus/corpus.py)")
+
 
 args = parser.parse_args()
 
+if args.sweep is not None:
+    run_sweep(list(SWEEPS) if "all" in args.sweep else args.sweep, args.output, args.corpus)
+    sys.exit(0)
+
 if args.chaintag is None:
     args.chaintag =  int('0xaa', 16)
 
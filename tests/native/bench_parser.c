@@ -0,0 +1,529 @@
+/*******************************************************************************
+*   Host-native benchmark of the transaction parser
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+/*
+ * Feeds generated transactions through processTx() with every chunk size from 1 to 255
+ * bytes, as the APDUs of INS_SIGN would, and:
+ * - checks that the hash and the parsed fields do not depend on the chunking, that the
+ *   hash is the BLAKE2b of the whole transaction, and that the data kept for the review is
+ *   its window and the BLAKE2b of the data of the first clause,
+ * - reports the parser throughput for each transaction shape,
+ * - reports the time spent in each RLP field, using the TRACE hooks of the parsers.
+ *
+ * With --corpus, replays the transactions of a corpus file (see tests/corpus/corpus.py)
+ * instead, and reports the throughput, the latency percentiles and how each transaction
+ * ends: accepted, rejected by the parser, or incomplete.
+ *
+ * Usage: bench_parser [--corpus <file.vtxc> [chunk size]]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "os.h"
+#include "cx.h"
+#include "vetUstream.h"
+#include "vetTrace.h"
+
+#define MAX_CHUNK_SIZE 255
+// Bytes parsed for each throughput measurement
+#define BENCH_BYTES (64 * 1024)
+#define TOKEN_TRANSFER_DATA_LENGTH 68
+#define CORPUS_MAGIC "VTXC"
+#define CORPUS_VERSION 1
+
+typedef struct buffer_t {
+    uint8_t *data;
+    size_t length;
+    size_t capacity;
+} buffer_t;
+
+typedef struct txShape_t {
+    const char *name;
+    uint32_t clauses;
+    uint32_t dataLength;
+    uint32_t valueLength;
+    uint32_t features;
+} txShape_t;
+
+typedef struct parseResult_t {
+    parserStatus_e status;
+    uint8_t hash[32];
+    txContent_t txContent;
+    clausesContent_t clausesContent;
+    clauseContent_t firstClause;
+    // Times the parser stopped after a clause
+    uint32_t suspensions;
+} parseResult_t;
+
+static const txShape_t SHAPES[] = {
+    {"VET transfer", 1, 0, 8, 0},
+    {"token transfer", 1, TOKEN_TRANSFER_DATA_LENGTH, 0, 0},
+    {"delegated transfer", 1, 0, 8, 1},
+    {"4 clauses, 64 B data", 4, 64, 8, 0},
+    {"16 clauses, 512 B data", 16, 512, 32, 0},
+    {"64 clauses", 64, 0, 32, 0},
+    {"1 clause, 4 KiB data", 1, 4096, 8, 0},
+};
+
+static const char *const FIELD_NAMES[TX_RLP_DONE] = {
+    "none", "content", "chainTag", "blockRef", "expiration", "clauses",
+    "gasPriceCoef", "gas", "dependsOn", "nonce", "reserved"
+};
+
+static bool fieldTiming;
+// Parse as the BAGL review does, stopping after each clause
+static bool suspendClauses;
+static uint64_t fieldStart;
+static uint8_t currentField;
+static uint64_t fieldNanos[TX_RLP_DONE];
+static uint64_t clauseCount;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void field_timing_close(void) {
+    uint64_t time = now_ns();
+    if (currentField != TX_RLP_NONE) {
+        fieldNanos[currentField] += time - fieldStart;
+    }
+    fieldStart = time;
+}
+
+// Host implementation of the trace hook: times the fields instead of recording events
+void vet_trace(uint8_t event, uint8_t arg0, uint16_t arg1) {
+    UNUSED(arg1);
+    if (!fieldTiming) {
+        return;
+    }
+    if (event == TRACE_TX_FIELD) {
+        field_timing_close();
+        currentField = arg0;
+    } else if (event == TRACE_CLAUSE) {
+        clauseCount++;
+    }
+}
+
+static void put(buffer_t *buffer, const uint8_t *data, size_t length) {
+    if (length == 0) {
+        return;
+    }
+    if (buffer->length + length > buffer->capacity) {
+        buffer->capacity = 2 * (buffer->length + length);
+        buffer->data = realloc(buffer->data, buffer->capacity);
+        if (buffer->data == NULL) {
+            abort();
+        }
+    }
+    memcpy(buffer->data + buffer->length, data, length);
+    buffer->length += length;
+}
+
+static void rlp_header(buffer_t *buffer, size_t length, uint8_t offset) {
+    uint8_t header[9];
+    uint8_t size = 0;
+    size_t i;
+
+    if (length < 56) {
+        header[0] = offset + length;
+        put(buffer, header, 1);
+        return;
+    }
+    for (i = length; i != 0; i >>= 8) {
+        size++;
+    }
+    header[0] = offset + 55 + size;
+    for (i = 0; i < size; i++) {
+        header[size - i] = (length >> (8 * i)) & 0xFF;
+    }
+    put(buffer, header, size + 1);
+}
+
+static void rlp_bytes(buffer_t *buffer, const uint8_t *data, size_t length) {
+    if ((length == 1) && (data[0] < 0x80)) {
+        put(buffer, data, 1);
+        return;
+    }
+    rlp_header(buffer, length, 0x80);
+    put(buffer, data, length);
+}
+
+static void rlp_uint(buffer_t *buffer, uint64_t value) {
+    uint8_t bytes[8];
+    uint8_t size = 0;
+    uint64_t v;
+    uint8_t i;
+
+    for (v = value; v != 0; v >>= 8) {
+        size++;
+    }
+    for (i = 0; i < size; i++) {
+        bytes[size - 1 - i] = (value >> (8 * i)) & 0xFF;
+    }
+    rlp_bytes(buffer, bytes, size);
+}
+
+static void rlp_list(buffer_t *buffer, buffer_t *items) {
+    rlp_header(buffer, items->length, 0xC0);
+    put(buffer, items->data, items->length);
+    items->length = 0;
+}
+
+// The data of every clause of a shape, to be freed
+static uint8_t *build_data(const txShape_t *shape) {
+    static const uint8_t transferId[4] = {0xa9, 0x05, 0x9c, 0xbb};
+    uint8_t *data = malloc(shape->dataLength + 1);
+    uint32_t i;
+
+    for (i = 0; i < shape->dataLength; i++) {
+        data[i] = (i * 7 + 1) & 0xFF;
+    }
+    if (shape->dataLength == TOKEN_TRANSFER_DATA_LENGTH) {
+        memcpy(data, transferId, sizeof(transferId));
+    }
+    return data;
+}
+
+static void build_tx(const txShape_t *shape, buffer_t *tx) {
+    static const uint8_t to[20] = {
+        0xd6, 0xfd, 0xbe, 0xb6, 0xd0, 0xfb, 0xc6, 0x90, 0xda, 0xbd,
+        0x35, 0x2c, 0xf9, 0x3b, 0x2f, 0x8d, 0x78, 0x2a, 0x46, 0xb5
+    };
+    static const uint8_t blockRef[8] = {0xab, 0xe4, 0x7d, 0x18, 0xda, 0xa1, 0x30, 0x1d};
+    buffer_t body = {0}, clauses = {0}, clause = {0}, reserved = {0};
+    uint8_t value[32];
+    uint8_t *data = build_data(shape);
+    uint32_t i;
+
+    for (i = 0; i < sizeof(value); i++) {
+        value[i] = 0x11 + i;
+    }
+
+    rlp_uint(&body, 0xAA);
+    rlp_bytes(&body, blockRef, sizeof(blockRef));
+    rlp_uint(&body, 0x2D0);
+    for (i = 0; i < shape->clauses; i++) {
+        rlp_bytes(&clause, to, sizeof(to));
+        rlp_bytes(&clause, value, shape->valueLength);
+        rlp_bytes(&clause, data, shape->dataLength);
+        rlp_list(&clauses, &clause);
+    }
+    rlp_list(&body, &clauses);
+    rlp_uint(&body, 128);
+    rlp_uint(&body, 21000 * shape->clauses);
+    rlp_bytes(&body, NULL, 0);
+    rlp_uint(&body, 0x1234);
+    if (shape->features != 0) {
+        rlp_uint(&reserved, shape->features);
+    }
+    rlp_list(&body, &reserved);
+    tx->length = 0;
+    rlp_list(tx, &body);
+
+    free(data);
+    free(body.data);
+    free(clauses.data);
+    free(clause.data);
+    free(reserved.data);
+}
+
+static void parse(uint8_t *tx, uint32_t length, uint32_t chunkSize, parseResult_t *result) {
+    txContext_t txContext;
+    clausesContext_t clausesContext;
+    clauseContext_t clauseContext;
+    cx_blake2b_t blake2b;
+    uint32_t offset;
+
+    memset(result, 0, sizeof(parseResult_t));
+    initTx(&txContext, &result->txContent, &clausesContext, &result->clausesContent,
+           &clauseContext, &result->firstClause, &blake2b, NULL);
+    clausesContext.suspendAfterClause = suspendClauses;
+    result->status = USTREAM_PROCESSING;
+    for (offset = 0; offset < length; offset += chunkSize) {
+        uint32_t size = (length - offset < chunkSize ? length - offset : chunkSize);
+        result->status = processTx(&txContext, &clausesContext, &clauseContext, tx + offset, size);
+        while (result->status == USTREAM_SUSPENDED) {
+            result->suspensions++;
+            clausesContext.suspended = false;
+            result->status = processTx(&txContext, &clausesContext, &clauseContext,
+                                       txContext.workBuffer, txContext.commandLength);
+        }
+        if (result->status == USTREAM_FAULT) {
+            return;
+        }
+    }
+    // The final hash is not part of any field
+    if (fieldTiming) {
+        field_timing_close();
+        currentField = TX_RLP_NONE;
+    }
+    CX_ASSERT(cx_hash_no_throw((cx_hash_t *) &blake2b, CX_LAST, NULL, 0, result->hash, 32));
+}
+
+// The clauses content keeps a pointer to the first clause, compare what it points to
+static bool same_result(const parseResult_t *a, const parseResult_t *b) {
+    return (a->status == b->status) &&
+           (memcmp(a->hash, b->hash, sizeof(a->hash)) == 0) &&
+           (memcmp(&a->txContent.gaspricecoef, &b->txContent.gaspricecoef, sizeof(txInt256_t)) == 0) &&
+           (memcmp(&a->txContent.gas, &b->txContent.gas, sizeof(txInt256_t)) == 0) &&
+           (a->txContent.features == b->txContent.features) &&
+           (a->clausesContent.clausesLength == b->clausesContent.clausesLength) &&
+           (a->clausesContent.dataPresent == b->clausesContent.dataPresent) &&
+           (memcmp(&a->firstClause, &b->firstClause, sizeof(clauseContent_t)) == 0);
+}
+
+// The window and the hash of the data of the first clause, whatever the length of the data
+static bool check_data(const txShape_t *shape, const clauseContent_t *clause) {
+    uint8_t *data = build_data(shape);
+    uint32_t kept = (shape->dataLength < CLAUSE_DATA_WINDOW ? shape->dataLength : CLAUSE_DATA_WINDOW);
+    uint8_t hash[32];
+    cx_blake2b_t blake2b;
+    bool ok;
+
+    CX_ASSERT(cx_blake2b_init_no_throw(&blake2b, 256));
+    CX_ASSERT(cx_hash_no_throw((cx_hash_t *) &blake2b, CX_LAST, data, shape->dataLength, hash, 32));
+    ok = (clause->data.length == shape->dataLength) &&
+         (memcmp(clause->data.window, data, kept) == 0) &&
+         ((shape->dataLength == 0) || (memcmp(clause->data.hash, hash, sizeof(hash)) == 0));
+    free(data);
+    return ok;
+}
+
+static bool check_shape(const txShape_t *shape, uint8_t *tx, uint32_t length) {
+    parseResult_t reference, result;
+    uint8_t hash[32];
+    cx_blake2b_t blake2b;
+    uint32_t chunkSize;
+    bool ok = true;
+
+    parse(tx, length, length, &reference);
+    CX_ASSERT(cx_blake2b_init_no_throw(&blake2b, 256));
+    CX_ASSERT(cx_hash_no_throw((cx_hash_t *) &blake2b, CX_LAST, tx, length, hash, 32));
+    if ((reference.status != USTREAM_FINISHED) || (memcmp(hash, reference.hash, 32) != 0) ||
+        (reference.clausesContent.clausesLength != shape->clauses) ||
+        (reference.txContent.features != shape->features) || !check_data(shape, &reference.firstClause)) {
+        fprintf(stderr, "%s: unexpected parse of the whole transaction\n", shape->name);
+        return false;
+    }
+    for (chunkSize = 1; chunkSize <= MAX_CHUNK_SIZE; chunkSize++) {
+        parse(tx, length, chunkSize, &result);
+        if (!same_result(&reference, &result)) {
+            fprintf(stderr, "%s: result differs with %u byte chunks\n", shape->name, chunkSize);
+            ok = false;
+        }
+    }
+    suspendClauses = true;
+    parse(tx, length, MAX_CHUNK_SIZE, &result);
+    suspendClauses = false;
+    if (!same_result(&reference, &result) || (result.suspensions != shape->clauses)) {
+        fprintf(stderr, "%s: result differs when suspended after each clause\n", shape->name);
+        ok = false;
+    }
+    return ok;
+}
+
+static double throughput(uint8_t *tx, uint32_t length, uint32_t chunkSize) {
+    parseResult_t result;
+    uint32_t iterations = BENCH_BYTES / length + 1;
+    uint32_t i;
+    uint64_t start = now_ns();
+
+    for (i = 0; i < iterations; i++) {
+        parse(tx, length, chunkSize, &result);
+    }
+    return ((double) length * iterations / 1e6) / ((now_ns() - start) / 1e9);
+}
+
+static void field_costs(uint8_t *tx, uint32_t length) {
+    parseResult_t result;
+    uint32_t iterations = BENCH_BYTES / length + 1;
+    uint32_t i;
+
+    memset(fieldNanos, 0, sizeof(fieldNanos));
+    clauseCount = 0;
+    fieldTiming = true;
+    for (i = 0; i < iterations; i++) {
+        currentField = TX_RLP_NONE;
+        fieldStart = now_ns();
+        parse(tx, length, MAX_CHUNK_SIZE, &result);
+    }
+    fieldTiming = false;
+
+    printf("    per field (ns):");
+    for (i = TX_RLP_CONTENT; i < TX_RLP_DONE; i++) {
+        printf(" %s %.0f", FIELD_NAMES[i], (double) fieldNanos[i] / iterations);
+    }
+    printf("\n    per clause (ns): %.0f\n",
+           clauseCount != 0 ? (double) fieldNanos[TX_RLP_CLAUSES] / clauseCount : 0.0);
+}
+
+static uint32_t read_be(const uint8_t *data, uint8_t size) {
+    uint32_t value = 0;
+    uint8_t i;
+
+    for (i = 0; i < size; i++) {
+        value = (value << 8) | data[i];
+    }
+    return value;
+}
+
+static int compare_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *) a, y = *(const uint64_t *) b;
+    return (x > y) - (x < y);
+}
+
+static int replay_corpus(const char *path, uint32_t chunkSize) {
+    FILE *f = fopen(path, "rb");
+    buffer_t corpus = {0};
+    uint8_t block[4096];
+    size_t length, offset;
+    uint64_t *latencies = NULL;
+    uint32_t count = 0, accepted = 0, rejected = 0, incomplete = 0, needSettings = 0;
+    uint64_t bytes = 0, nanos = 0;
+
+    if (f == NULL) {
+        perror(path);
+        return 1;
+    }
+    while ((length = fread(block, 1, sizeof(block), f)) != 0) {
+        put(&corpus, block, length);
+    }
+    fclose(f);
+    if ((corpus.length < 5) || (memcmp(corpus.data, CORPUS_MAGIC, 4) != 0) ||
+        (corpus.data[4] != CORPUS_VERSION)) {
+        fprintf(stderr, "%s is not a version %d corpus\n", path, CORPUS_VERSION);
+        return 1;
+    }
+
+    for (offset = 5; offset + 2 <= corpus.length;) {
+        parseResult_t result;
+        uint8_t hash[32];
+        cx_blake2b_t blake2b;
+        uint32_t iterations, i;
+        uint64_t start, elapsed;
+        uint8_t *tx;
+
+        // Metadata is only for the Python tools
+        offset += 2 + read_be(corpus.data + offset, 2);
+        if (offset + 4 > corpus.length) {
+            break;
+        }
+        length = read_be(corpus.data + offset, 4);
+        tx = corpus.data + offset + 4;
+        offset += 4 + length;
+        if ((length == 0) || (offset > corpus.length)) {
+            fprintf(stderr, "%s: truncated record\n", path);
+            return 1;
+        }
+
+        parse(tx, length, chunkSize, &result);
+        CX_ASSERT(cx_blake2b_init_no_throw(&blake2b, 256));
+        CX_ASSERT(cx_hash_no_throw((cx_hash_t *) &blake2b, CX_LAST, tx, length, hash, 32));
+        if (result.status == USTREAM_FAULT) {
+            rejected++;
+        } else if (result.status == USTREAM_PROCESSING) {
+            incomplete++;
+        } else if (memcmp(hash, result.hash, 32) != 0) {
+            fprintf(stderr, "%s: hash mismatch for transaction %u\n", path, count);
+            return 1;
+        } else {
+            accepted++;
+            if (result.clausesContent.dataPresent || (result.clausesContent.clausesLength > 1)) {
+                needSettings++;
+            }
+        }
+
+        iterations = BENCH_BYTES / length + 1;
+        start = now_ns();
+        for (i = 0; i < iterations; i++) {
+            parse(tx, length, chunkSize, &result);
+        }
+        elapsed = now_ns() - start;
+        bytes += (uint64_t) length * iterations;
+        nanos += elapsed;
+        latencies = realloc(latencies, (count + 1) * sizeof(uint64_t));
+        if (latencies == NULL) {
+            abort();
+        }
+        latencies[count++] = elapsed / iterations;
+    }
+    free(corpus.data);
+    if (count == 0) {
+        fprintf(stderr, "%s: empty corpus\n", path);
+        return 1;
+    }
+
+    qsort(latencies, count, sizeof(uint64_t), compare_u64);
+    printf("%u transactions, %u B chunks: %.2f MB/s\n", count, chunkSize, (bytes / 1e6) / (nanos / 1e9));
+    printf("latency (ns): p50 %llu  p90 %llu  p99 %llu  max %llu\n",
+           (unsigned long long) latencies[count / 2],
+           (unsigned long long) latencies[(count * 9) / 10],
+           (unsigned long long) latencies[(count * 99) / 100],
+           (unsigned long long) latencies[count - 1]);
+    printf("accepted %u (%u need the contract data or multi-clause setting), rejected %u, incomplete %u\n",
+           accepted, needSettings, rejected, incomplete);
+    free(latencies);
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    buffer_t tx = {0};
+    bool ok = true;
+    size_t i;
+
+    if ((argc >= 3) && (strcmp(argv[1], "--corpus") == 0)) {
+        uint32_t chunkSize = (argc >= 4 ? strtoul(argv[3], NULL, 0) : MAX_CHUNK_SIZE);
+        if ((chunkSize == 0) || (chunkSize > MAX_CHUNK_SIZE)) {
+            fprintf(stderr, "chunk size must be between 1 and %d\n", MAX_CHUNK_SIZE);
+            return 1;
+        }
+        return replay_corpus(argv[2], chunkSize);
+    }
+    for (i = 0; i < sizeof(SHAPES) / sizeof(SHAPES[0]); i++) {
+        const txShape_t *shape = &SHAPES[i];
+        double best = 0, worst = 0;
+        uint32_t worstChunk = 0, chunkSize;
+
+        build_tx(shape, &tx);
+        if (!check_shape(shape, tx.data, tx.length)) {
+            ok = false;
+            continue;
+        }
+        for (chunkSize = 1; chunkSize <= MAX_CHUNK_SIZE; chunkSize++) {
+            double rate = throughput(tx.data, tx.length, chunkSize);
+            if ((worstChunk == 0) || (rate < worst)) {
+                worst = rate;
+                worstChunk = chunkSize;
+            }
+            if (rate > best) {
+                best = rate;
+            }
+        }
+        printf("%-24s %6zu B  %7.2f MB/s (255 B chunks)  best %7.2f  worst %7.2f (%u B chunks)\n",
+               shape->name, tx.length, throughput(tx.data, tx.length, MAX_CHUNK_SIZE),
+               best, worst, worstChunk);
+        field_costs(tx.data, tx.length);
+    }
+    free(tx.data);
+    if (!ok) {
+        fprintf(stderr, "FAILED\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,144 @@
+/*******************************************************************************
+*   Host stand-in for the BOLOS hash functions used by common/
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "cx.h"
+
+static const uint64_t blake2b_iv[8] = {
+    0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL, 0xa54ff53a5f1d36f1ULL,
+    0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL, 0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL
+};
+
+static const uint8_t blake2b_sigma[12][16] = {
+    {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+    {14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3},
+    {11, 8, 12, 0, 5, 2, 15, 13, 10, 14, 3, 6, 7, 1, 9, 4},
+    {7, 9, 3, 1, 13, 12, 11, 14, 2, 6, 5, 10, 4, 0, 15, 8},
+    {9, 0, 5, 7, 2, 4, 10, 15, 14, 1, 11, 12, 6, 8, 3, 13},
+    {2, 12, 6, 10, 0, 11, 8, 3, 4, 13, 7, 5, 15, 14, 1, 9},
+    {12, 5, 1, 15, 14, 13, 4, 10, 0, 7, 6, 3, 9, 2, 8, 11},
+    {13, 11, 7, 14, 12, 1, 3, 9, 5, 0, 15, 4, 8, 6, 2, 10},
+    {6, 15, 14, 9, 11, 3, 0, 8, 12, 2, 13, 7, 1, 4, 10, 5},
+    {10, 2, 8, 4, 7, 6, 1, 5, 15, 11, 9, 14, 3, 12, 13, 0},
+    {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+    {14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3}
+};
+
+#define ROTR64(x, n) (((x) >> (n)) | ((x) << (64 - (n))))
+
+#define G(a, b, c, d, x, y)          \
+    do {                             \
+        v[a] = v[a] + v[b] + (x);    \
+        v[d] = ROTR64(v[d] ^ v[a], 32); \
+        v[c] = v[c] + v[d];          \
+        v[b] = ROTR64(v[b] ^ v[c], 24); \
+        v[a] = v[a] + v[b] + (y);    \
+        v[d] = ROTR64(v[d] ^ v[a], 16); \
+        v[c] = v[c] + v[d];          \
+        v[b] = ROTR64(v[b] ^ v[c], 63); \
+    } while (0)
+
+static void blake2b_compress(cx_blake2b_t *hash, bool last) {
+    uint64_t v[16];
+    uint64_t m[16];
+    int i;
+
+    for (i = 0; i < 8; i++) {
+        v[i] = hash->h[i];
+        v[i + 8] = blake2b_iv[i];
+    }
+    v[12] ^= hash->t[0];
+    v[13] ^= hash->t[1];
+    if (last) {
+        v[14] = ~v[14];
+    }
+    for (i = 0; i < 16; i++) {
+        m[i] = 0;
+        for (int j = 7; j >= 0; j--) {
+            m[i] = (m[i] << 8) | hash->buffer[8 * i + j];
+        }
+    }
+    for (i = 0; i < 12; i++) {
+        G(0, 4, 8, 12, m[blake2b_sigma[i][0]], m[blake2b_sigma[i][1]]);
+        G(1, 5, 9, 13, m[blake2b_sigma[i][2]], m[blake2b_sigma[i][3]]);
+        G(2, 6, 10, 14, m[blake2b_sigma[i][4]], m[blake2b_sigma[i][5]]);
+        G(3, 7, 11, 15, m[blake2b_sigma[i][6]], m[blake2b_sigma[i][7]]);
+        G(0, 5, 10, 15, m[blake2b_sigma[i][8]], m[blake2b_sigma[i][9]]);
+        G(1, 6, 11, 12, m[blake2b_sigma[i][10]], m[blake2b_sigma[i][11]]);
+        G(2, 7, 8, 13, m[blake2b_sigma[i][12]], m[blake2b_sigma[i][13]]);
+        G(3, 4, 9, 14, m[blake2b_sigma[i][14]], m[blake2b_sigma[i][15]]);
+    }
+    for (i = 0; i < 8; i++) {
+        hash->h[i] ^= v[i] ^ v[i + 8];
+    }
+}
+
+cx_err_t cx_blake2b_init_no_throw(cx_blake2b_t *hash, size_t size) {
+    int i;
+
+    if ((size == 0) || (size > 512) || (size % 8 != 0)) {
+        return EXCEPTION;
+    }
+    memset(hash, 0, sizeof(cx_blake2b_t));
+    hash->outputLength = size / 8;
+    for (i = 0; i < 8; i++) {
+        hash->h[i] = blake2b_iv[i];
+    }
+    hash->h[0] ^= 0x01010000 ^ hash->outputLength;
+    return CX_OK;
+}
+
+cx_err_t cx_hash_no_throw(cx_hash_t *header, uint32_t mode, const uint8_t *in, size_t len,
+                          uint8_t *out, size_t out_len) {
+    cx_blake2b_t *hash = (cx_blake2b_t *) header;
+    size_t i;
+
+    for (i = 0; i < len; i++) {
+        if (hash->bufferLength == sizeof(hash->buffer)) {
+            hash->t[0] += hash->bufferLength;
+            if (hash->t[0] < hash->bufferLength) {
+                hash->t[1]++;
+            }
+            blake2b_compress(hash, false);
+            hash->bufferLength = 0;
+        }
+        hash->buffer[hash->bufferLength++] = in[i];
+    }
+    if (mode & CX_LAST) {
+        if (out_len < hash->outputLength) {
+            return EXCEPTION;
+        }
+        hash->t[0] += hash->bufferLength;
+        if (hash->t[0] < hash->bufferLength) {
+            hash->t[1]++;
+        }
+        memset(hash->buffer + hash->bufferLength, 0, sizeof(hash->buffer) - hash->bufferLength);
+        blake2b_compress(hash, true);
+        for (i = 0; i < hash->outputLength; i++) {
+            out[i] = (hash->h[i / 8] >> (8 * (i % 8))) & 0xFF;
+        }
+    }
+    return CX_OK;
+}
+
+cx_err_t cx_keccak_256_hash(const uint8_t *in, size_t len, uint8_t *out) {
+    UNUSED(in);
+    UNUSED(len);
+    UNUSED(out);
+    fprintf(stderr, "cx_keccak_256_hash is not available on the host\n");
+    abort();
+}
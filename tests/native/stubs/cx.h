@@ -0,0 +1,62 @@
+/*******************************************************************************
+*   Host stand-in for the parts of the BOLOS cx.h used by common/
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#ifndef _NATIVE_CX_H_
+#define _NATIVE_CX_H_
+
+#include "os.h"
+
+#define CX_OK 0
+#define CX_LAST 1
+
+typedef int cx_err_t;
+
+typedef struct cx_hash_s {
+    int algorithm;
+} cx_hash_t;
+
+typedef struct cx_blake2b_s {
+    cx_hash_t header;
+    uint64_t h[8];
+    uint64_t t[2];
+    uint8_t buffer[128];
+    size_t bufferLength;
+    size_t outputLength;
+} cx_blake2b_t;
+
+typedef struct cx_ecfp_public_key_s {
+    int curve;
+    size_t W_len;
+    uint8_t W[65];
+} cx_ecfp_public_key_t;
+
+#define CX_ASSERT(call)                    \
+    do {                                   \
+        cx_err_t __err = (call);           \
+        if (__err != CX_OK) {              \
+            THROW(__err);                  \
+        }                                  \
+    } while (0)
+
+// Real BLAKE2b (RFC 7693), hashes match the device
+cx_err_t cx_blake2b_init_no_throw(cx_blake2b_t *hash, size_t size);
+cx_err_t cx_hash_no_throw(cx_hash_t *hash, uint32_t mode, const uint8_t *in, size_t len,
+                          uint8_t *out, size_t out_len);
+
+// Only used by the address helpers of vetUtils.c, not by the parsers
+cx_err_t cx_keccak_256_hash(const uint8_t *in, size_t len, uint8_t *out);
+
+#endif
@@ -0,0 +1,29 @@
+/*******************************************************************************
+*   Host stand-in for the BOLOS exception model
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "os.h"
+
+try_context_t *G_try_last;
+
+void os_longjmp(unsigned int exception) {
+    if (G_try_last == NULL) {
+        fprintf(stderr, "Uncaught exception 0x%04x\n", exception);
+        abort();
+    }
+    longjmp(G_try_last->jmp_buf, exception);
+}
@@ -0,0 +1,69 @@
+/*******************************************************************************
+*   Host stand-in for the parts of the BOLOS os.h used by common/
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#ifndef _NATIVE_OS_H_
+#define _NATIVE_OS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <setjmp.h>
+
+#define EXCEPTION 1
+
+#define PRINTF(...)
+#define UNUSED(x) (void)(x)
+#define PIC(x) (x)
+
+typedef unsigned short exception_t;
+
+typedef struct try_context_s {
+    jmp_buf jmp_buf;
+    struct try_context_s *previous;
+    exception_t ex;
+} try_context_t;
+
+extern try_context_t *G_try_last;
+
+void os_longjmp(unsigned int exception) __attribute__((noreturn));
+
+/*
+ * Same usage as the SDK:
+ *   BEGIN_TRY { TRY { ... } CATCH_OTHER(e) { ... } FINALLY { ... } } END_TRY;
+ */
+#define BEGIN_TRY                                 \
+    {                                             \
+        try_context_t __try_context;              \
+        __try_context.previous = G_try_last;
+
+#define TRY                                                   \
+    G_try_last = &__try_context;                              \
+    __try_context.ex = setjmp(__try_context.jmp_buf);         \
+    if (__try_context.ex == 0)
+
+#define CATCH_OTHER(e)                            \
+    exception_t e = __try_context.ex;             \
+    G_try_last = __try_context.previous;          \
+    if (e != 0)
+
+#define FINALLY
+
+#define END_TRY }
+
+#define THROW(x) os_longjmp(x)
+
+#endif
@@ -0,0 +1,89 @@
+# RAM report of the application, from the ELF file of a build (bin/app.elf)
+#
+# Lists the size of every global symbol in RAM, biggest first, then the size of each
+# member of the unions sharing RAM (tmpCtx, displayContext, tmpContent), whose largest
+# member sets the size of the union.
+#
+# Usage: python3 ram_report.py [bin/app.elf]
+# Requires pyelftools (pip install pyelftools)
+import sys
+from elftools.elf.elffile import ELFFile
+from elftools.elf.sections import SymbolTableSection
+
+UNIONS = ["tmpCtx", "displayContext", "tmpContent"]
+RAM_SECTIONS = [".bss", ".data"]
+
+
+def ram_symbols(elf: ELFFile) -> list:
+    ram_indexes = [i for i, section in enumerate(elf.iter_sections()) if section.name in RAM_SECTIONS]
+    symbols = []
+    for section in elf.iter_sections():
+        if not isinstance(section, SymbolTableSection):
+            continue
+        for symbol in section.iter_symbols():
+            if (symbol["st_info"]["type"] == "STT_OBJECT" and symbol["st_size"] > 0 and
+                    symbol["st_shndx"] in ram_indexes):
+                symbols.append((symbol.name, symbol["st_size"]))
+    return sorted(symbols, key=lambda symbol: -symbol[1])
+
+
+def type_die(die):
+    return die.get_DIE_from_attribute("DW_AT_type") if "DW_AT_type" in die.attributes else None
+
+
+def type_size(die) -> int:
+    # Follow typedefs and qualifiers up to a sized type
+    while die is not None and "DW_AT_byte_size" not in die.attributes:
+        if die.tag == "DW_TAG_array_type":
+            count = 1
+            for child in die.iter_children():
+                if "DW_AT_count" in child.attributes:
+                    count *= child.attributes["DW_AT_count"].value
+                elif "DW_AT_upper_bound" in child.attributes:
+                    count *= child.attributes["DW_AT_upper_bound"].value + 1
+            return count * type_size(type_die(die))
+        die = type_die(die)
+    return die.attributes["DW_AT_byte_size"].value if die is not None else 0
+
+
+def union_members(elf: ELFFile, name: str) -> list:
+    if not elf.has_dwarf_info():
+        return []
+    for cu in elf.get_dwarf_info().iter_CUs():
+        for die in cu.iter_DIEs():
+            if (die.tag == "DW_TAG_variable" and "DW_AT_name" in die.attributes and
+                    die.attributes["DW_AT_name"].value.decode() == name):
+                union = type_die(die)
+                while union is not None and union.tag != "DW_TAG_union_type":
+                    union = type_die(union)
+                if union is None:
+                    continue
+                return [(child.attributes["DW_AT_name"].value.decode(), type_size(type_die(child)))
+                        for child in union.iter_children()
+                        if child.tag == "DW_TAG_member" and "DW_AT_name" in child.attributes]
+    return []
+
+
+def main() -> None:
+    path = sys.argv[1] if len(sys.argv) > 1 else "bin/app.elf"
+    with open(path, "rb") as f:
+        elf = ELFFile(f)
+
+        symbols = ram_symbols(elf)
+        print(f"{'Symbol':<40} {'Bytes':>8}")
+        for name, size in symbols:
+            print(f"{name:<40} {size:>8}")
+        print(f"{'Total':<40} {sum(size for _, size in symbols):>8}")
+
+        for name in UNIONS:
+            members = union_members(elf, name)
+            if not members:
+                continue
+            print()
+            print(f"{name}")
+            for member, size in sorted(members, key=lambda member: -member[1]):
+                print(f"  {member:<38} {size:>8}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,108 @@
+from ragger.navigator import NavInsID
+from ragger.backend import RaisePolicy, SpeculosBackend
+from utils import check_signature_validity
+from vechain_client import VechainClient, Errors, P1, unpack_get_public_key_response
+
+# Transfer of 5 VET to 0xd6FdBEB6d0FBC690DaBD352cF93b2f8D782A46B5, as in test_sign_tx_cmd.py
+transaction : bytes = bytes.fromhex("f83a81aa88aae47d18daa1301d8202d0e0df94d6fdbeb6d0fbc690dabd352cf93b2f8d782a46b5884563918244f4000080818082520880821234c0")
+recipient : bytes = bytes.fromhex("d6fdbeb6d0fbc690dabd352cf93b2f8d782a46b5")
+label : str = "Cold wallet 1"
+
+# The path used for all tests
+path: str = "m/44'/818'/0'/0/0"
+
+
+def approve_address_book(firmware, navigator, text: str):
+    if firmware.device.startswith("nano"):
+        navigator.navigate_until_text(NavInsID.RIGHT_CLICK,
+                                      [NavInsID.BOTH_CLICK],
+                                      "Approve")
+    else:
+        navigator.navigate_until_text(NavInsID.USE_CASE_REVIEW_TAP,
+                                      [NavInsID.USE_CASE_REVIEW_CONFIRM,
+                                       NavInsID.USE_CASE_STATUS_DISMISS],
+                                      text)
+
+
+# In this test we add a recipient to the address book, then check that a transfer
+# to it is reviewed with its label, and remove it
+def test_address_book_add_and_sign(firmware, backend, navigator):
+    client = VechainClient(backend)
+    response = client.get_public_key(path=path).data
+    _, public_key = unpack_get_public_key_response(response)
+
+    with client.address_book_add(recipient, label):
+        approve_address_book(firmware, navigator, "Add address")
+    assert client.get_async_response().status == 0x9000
+
+    with client.sign_tx(path=path, transaction=transaction):
+        if firmware.device.startswith("nano"):
+            navigator.navigate_until_text(NavInsID.RIGHT_CLICK,
+                                          [],
+                                          label)
+            navigator.navigate_until_text(NavInsID.RIGHT_CLICK,
+                                          [NavInsID.BOTH_CLICK],
+                                          "Accept",
+                                          screen_change_before_first_instruction=False)
+        else:
+            navigator.navigate_until_text(NavInsID.USE_CASE_REVIEW_TAP,
+                                          [],
+                                          label)
+            navigator.navigate_until_text(NavInsID.USE_CASE_REVIEW_TAP,
+                                          [NavInsID.USE_CASE_REVIEW_CONFIRM,
+                                           NavInsID.USE_CASE_STATUS_DISMISS],
+                                          "Hold to sign")
+    response = client.get_async_response().data
+    if isinstance(backend, SpeculosBackend):
+        assert check_signature_validity(public_key, response, transaction)
+
+    with client.address_book_remove(recipient):
+        approve_address_book(firmware, navigator, "Remove address")
+    assert client.get_async_response().status == 0x9000
+
+    # Removed entries are not found any more
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+    rapdu = client.address_book(P1.P1_ADDRESS_BOOK_REMOVE, recipient)
+    assert rapdu.status == Errors.SW_REFERENCED_DATA_NOT_FOUND
+
+
+# In this test we check that a rejected entry is not added
+def test_address_book_add_refused(firmware, backend, navigator):
+    client = VechainClient(backend)
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+
+    with client.address_book_add(recipient, label):
+        if firmware.device.startswith("nano"):
+            navigator.navigate_until_text(NavInsID.RIGHT_CLICK,
+                                          [NavInsID.BOTH_CLICK],
+                                          "Reject")
+        else:
+            navigator.navigate([NavInsID.USE_CASE_REVIEW_REJECT,
+                                NavInsID.USE_CASE_CHOICE_CONFIRM,
+                                NavInsID.USE_CASE_STATUS_DISMISS])
+    assert client.get_async_response().status == Errors.SW_TRANSACTION_CANCELLED
+
+    rapdu = client.address_book(P1.P1_ADDRESS_BOOK_REMOVE, recipient)
+    assert rapdu.status == Errors.SW_REFERENCED_DATA_NOT_FOUND
+
+
+# In this test we check the requests refused before their review
+def test_address_book_invalid(backend):
+    client = VechainClient(backend)
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+
+    requests = [
+        # Missing label
+        (P1.P1_ADDRESS_BOOK_ADD, recipient),
+        # Label too long
+        (P1.P1_ADDRESS_BOOK_ADD, recipient + b"A" * 21),
+        # Label not printable
+        (P1.P1_ADDRESS_BOOK_ADD, recipient + b"Cold\nwallet"),
+        # Truncated address
+        (P1.P1_ADDRESS_BOOK_REMOVE, recipient[:19]),
+        # Label of a removed address
+        (P1.P1_ADDRESS_BOOK_REMOVE, recipient + label.encode()),
+    ]
+    for p1, data in requests:
+        rapdu = client.address_book(p1, data)
+        assert rapdu.status == Errors.SW_INCORRECT_DATA
@@ -0,0 +1,49 @@
+from hashlib import blake2b
+from ragger.navigator import NavInsID
+from ragger.backend import RaisePolicy
+from vechain_client import VechainClient, Errors
+
+# Same transaction as in test_sign_tx_cmd.py
+transaction : bytes = bytes.fromhex("f83a81aa88aae47d18daa1301d8202d0e0df94d6fdbeb6d0fbc690dabd352cf93b2f8d782a46b5884563918244f4000080818082520880821234c0")
+
+# The path used for all tests
+path: str = "m/44'/818'/0'/0/0"
+
+
+# In this test we read again the signature of an approved transaction, as if it had been lost
+def test_get_last_response(firmware, backend, navigator):
+    client = VechainClient(backend)
+
+    with client.sign_tx(path=path, transaction=transaction):
+        if firmware.device.startswith("nano"):
+            navigator.navigate_until_text(NavInsID.RIGHT_CLICK,
+                                          [NavInsID.BOTH_CLICK],
+                                          "Accept")
+        else:
+            navigator.navigate([
+                NavInsID.USE_CASE_REVIEW_TAP,
+                NavInsID.USE_CASE_REVIEW_TAP,
+                NavInsID.USE_CASE_REVIEW_CONFIRM,
+                NavInsID.USE_CASE_STATUS_DISMISS
+            ])
+
+    signature = client.get_async_response().data
+    signing_hash = blake2b(transaction, digest_size=32).digest()
+
+    # The same response is sent again, without any review
+    assert client.get_last_response(signing_hash).data == signature
+    # Other commands do not discard it
+    client.get_app_configuration()
+    assert client.get_last_response(signing_hash).data == signature
+
+
+# The response is only sent back for the signing hash it covers
+def test_get_last_response_unknown_hash(backend):
+    client = VechainClient(backend)
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+
+    rapdu = client.get_last_response(bytes(32))
+    assert rapdu.status == Errors.SW_REFERENCED_DATA_NOT_FOUND
+
+    rapdu = client.get_last_response(bytes(31))
+    assert rapdu.status == Errors.SW_INCORRECT_DATA
@@ -0,0 +1,83 @@
+from ragger.backend import RaisePolicy
+from vechain_client import VechainClient, InsType, Errors, P1, unpack_get_stats_response, unpack_get_memory_response
+
+# The path used for all tests
+path: str = "m/44'/818'/0'/0/0"
+
+
+# In this test we check that the counters follow the APDUs sent to the device
+def test_get_stats(backend):
+    client = VechainClient(backend)
+
+    # Start from zero
+    client.get_stats(reset=True)
+
+    client.get_app_configuration()
+    client.get_app_configuration()
+    client.get_public_key(path=path)
+
+    stats = unpack_get_stats_response(client.get_stats().data)
+
+    configuration = stats[InsType.INS_GET_APP_CONFIGURATION]
+    assert configuration["calls"] == 2
+    assert configuration["bytes_in"] == 0
+    assert configuration["bytes_out"] == 2 * (4 + 2)
+    assert configuration["errors"] == 0
+
+    public_key = stats[InsType.INS_GET_PUBLIC_KEY]
+    assert public_key["calls"] == 1
+    assert public_key["bytes_in"] == len(bytes.fromhex("058000002c80000332800000000000000000000000"))
+
+    # The read itself is counted once it has been sent
+    assert stats[InsType.INS_GET_STATS]["calls"] == 1
+    assert stats[InsType.INS_GET_STATS]["bytes_out"] == 0
+
+
+# Errors are counted with their status word
+def test_get_stats_errors(backend):
+    client = VechainClient(backend)
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+
+    client.get_stats(reset=True)
+    backend.exchange(cla=0xE0, ins=InsType.INS_GET_APP_CONFIGURATION, p1=0, p2=0, data=b"")
+    backend.exchange(cla=0xE0, ins=0x7F, p1=0, p2=0, data=b"")
+    assert client.get_stats(page=0x7F).status == 0x6B00
+
+    stats = unpack_get_stats_response(client.get_stats().data)
+    assert stats[0xFF]["calls"] == 1
+    assert stats[0xFF]["errors"] == 1
+    assert stats[0xFF]["last_error"] == 0x6D00
+    assert stats[InsType.INS_GET_STATS]["errors"] == 1
+    assert stats[InsType.INS_GET_STATS]["last_error"] == 0x6B00
+
+
+# Each instruction of the application has its own counters
+def test_get_stats_instructions(backend):
+    client = VechainClient(backend)
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+
+    client.get_stats(reset=True)
+    # Truncated address
+    client.address_book(P1.P1_ADDRESS_BOOK_REMOVE, bytes(19))
+    # Missing descriptor, or no trusted key in this build
+    client.provide_token_info(b"")
+
+    stats = unpack_get_stats_response(client.get_stats().data)
+    assert stats[InsType.INS_ADDRESS_BOOK]["calls"] == 1
+    assert stats[InsType.INS_ADDRESS_BOOK]["last_error"] == Errors.SW_INCORRECT_DATA
+    assert stats[InsType.INS_PROVIDE_TOKEN_INFO]["calls"] == 1
+    assert stats[InsType.INS_PROVIDE_TOKEN_INFO]["errors"] == 1
+    assert stats[0xFF]["calls"] == 0
+
+
+# The stack high-water mark grows with the requests sent since the stack was painted
+def test_get_stats_memory(backend):
+    client = VechainClient(backend)
+
+    client.get_stats(page=2, reset=True)
+    stack_size, idle_used = unpack_get_memory_response(client.get_stats(page=2).data)
+    assert 0 < idle_used < stack_size
+
+    client.get_public_key(path=path)
+    _, used = unpack_get_memory_response(client.get_stats(page=2).data)
+    assert idle_used <= used < stack_size
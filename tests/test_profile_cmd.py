@@ -0,0 +1,57 @@
+import pytest
+from ragger.navigator import NavInsID
+from ragger.backend import RaisePolicy
+from vechain_client import VechainClient, InsType, unpack_get_profile_response, unpack_get_stats_response
+
+# Same transaction as in test_sign_tx_cmd.py
+transaction : bytes = bytes.fromhex("f83a81aa88aae47d18daa1301d8202d0e0df94d6fdbeb6d0fbc690dabd352cf93b2f8d782a46b5884563918244f4000080818082520880821234c0")
+
+# The path used for all tests
+path: str = "m/44'/818'/0'/0/0"
+
+
+# In this test we read the stage breakdown of a transaction signature from a PROFILE=1 build
+def test_profile_sign_tx(firmware, backend, navigator):
+    client = VechainClient(backend)
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+
+    if client.get_stats(page=1).status != 0x9000:
+        pytest.skip("The application is not built with PROFILE=1")
+
+    with client.sign_tx(path=path, transaction=transaction):
+        if firmware.device.startswith("nano"):
+            navigator.navigate_until_text(NavInsID.RIGHT_CLICK,
+                                          [NavInsID.BOTH_CLICK],
+                                          "Accept")
+        else:
+            navigator.navigate([
+                NavInsID.USE_CASE_REVIEW_TAP,
+                NavInsID.USE_CASE_REVIEW_TAP,
+                NavInsID.USE_CASE_REVIEW_CONFIRM,
+                NavInsID.USE_CASE_STATUS_DISMISS
+            ])
+
+    profile = unpack_get_profile_response(client.get_stats(page=1).data)
+    # A single block transaction, hashed and signed once with a key derived once
+    for stage in ["path", "parse", "hash", "derive", "sign"]:
+        assert profile[stage] == 1, stage
+    # Each value is formatted once, when its screen is first displayed
+    assert profile["format_fee"] == 1
+    assert profile["format_amount"] >= 1
+
+
+# Resetting the profile page clears the breakdown and keeps the instruction counters
+def test_profile_reset(backend):
+    client = VechainClient(backend)
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+
+    if client.get_stats(page=1).status != 0x9000:
+        pytest.skip("The application is not built with PROFILE=1")
+
+    client.get_app_configuration()
+    client.get_stats(page=1, reset=True)
+    profile = unpack_get_profile_response(client.get_stats(page=1).data)
+    assert all(runs == 0 for runs in profile.values())
+
+    stats = unpack_get_stats_response(client.get_stats().data)
+    assert stats[InsType.INS_GET_APP_CONFIGURATION]["calls"] >= 1
@@ -0,0 +1,119 @@
+import pytest
+from hashlib import sha256
+from ecdsa.curves import SECP256k1
+from ecdsa.keys import SigningKey
+from ecdsa.util import sigencode_der
+from ragger.navigator import NavInsID, NavIns
+from ragger.backend import RaisePolicy, SpeculosBackend
+from utils import check_signature_validity, settingEnables
+from vechain_client import VechainClient, Errors, unpack_get_public_key_response
+
+# Key trusted by the TOKEN_TEST_KEY=1 builds
+TOKEN_SIGNER_KEY = SigningKey.from_string(sha256(b"VeChain token signer test key").digest(), curve=SECP256k1)
+# Signed ahead of the descriptor
+TOKEN_DESCRIPTOR_TAG = b"VeChain token descriptor"
+
+token : bytes = bytes.fromhex("1234567890abcdef1234567890abcdef12345678")
+
+# Input
+# chaintag = 0xAA
+# expiration = 0x2D0
+# gaspricecoef = 128
+# gas = 80000
+# dependson = ""
+# nonce = "0x1234"
+# to = "0x1234567890abcdef1234567890abcdef12345678"
+# amount = 0
+# data = transfer("0xd6FdBEB6d0FBC690DaBD352cF93b2f8D782A46B5", 5000000)
+# blockref = "0xabe47d18daa1301d"
+# transaction message
+transaction : bytes = bytes.fromhex("f87981aa88abe47d18daa1301d8202d0f85ef85c941234567890abcdef1234567890abcdef1234567880b844a9059cbb000000000000000000000000d6fdbeb6d0fbc690dabd352cf93b2f8d782a46b500000000000000000000000000000000000000000000000000000000004c4b4081808301388080821234c0")
+
+# The path used for all tests
+path: str = "m/44'/818'/0'/0/0"
+
+
+def token_descriptor(ticker: str, address: bytes, decimals: int, key: SigningKey = TOKEN_SIGNER_KEY) -> bytes:
+    descriptor = bytes([len(ticker)]) + ticker.encode() + address + bytes([decimals])
+    return descriptor + key.sign_deterministic(TOKEN_DESCRIPTOR_TAG + descriptor, hashfunc=sha256,
+                                               sigencode=sigencode_der)
+
+
+def provide_token_info(client, descriptor: bytes):
+    rapdu = client.provide_token_info(descriptor)
+    if rapdu.status == 0x6D00:
+        pytest.skip("The application is not built with TOKEN_TEST_KEY=1")
+    return rapdu
+
+
+# In this test we provide a token, then check that its transfer is reviewed with its ticker and decimals
+def test_provide_token_info(firmware, backend, navigator):
+    client = VechainClient(backend)
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+    response = client.get_public_key(path=path).data
+    _, public_key = unpack_get_public_key_response(response)
+    settingEnables(firmware.device, navigator.navigate, NavInsID, NavIns)
+
+    assert provide_token_info(client, token_descriptor("TKN", token, 6)).status == 0x9000
+
+    with client.sign_tx(path=path, transaction=transaction):
+        if firmware.device.startswith("nano"):
+            navigator.navigate_until_text(NavInsID.RIGHT_CLICK,
+                                          [],
+                                          "TKN 5")
+            navigator.navigate_until_text(NavInsID.RIGHT_CLICK,
+                                          [NavInsID.BOTH_CLICK],
+                                          "Accept",
+                                          screen_change_before_first_instruction=False)
+        else:
+            navigator.navigate_until_text(NavInsID.USE_CASE_REVIEW_TAP,
+                                          [],
+                                          "TKN 5")
+            navigator.navigate_until_text(NavInsID.USE_CASE_REVIEW_TAP,
+                                          [NavInsID.USE_CASE_REVIEW_CONFIRM,
+                                           NavInsID.USE_CASE_STATUS_DISMISS],
+                                          "Hold to sign")
+    response = client.get_async_response().data
+    if isinstance(backend, SpeculosBackend):
+        assert check_signature_validity(public_key, response, transaction)
+
+
+# In this test we check that the descriptors not signed by the trusted key or malformed are rejected
+def test_provide_token_info_invalid(backend):
+    client = VechainClient(backend)
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+
+    other_key = SigningKey.from_string(sha256(b"Another key").digest(), curve=SECP256k1)
+    valid = token_descriptor("TKN", token, 6)
+    descriptors = [
+        # Signed by another key
+        token_descriptor("TKN", token, 6, other_key),
+        # Signature of another descriptor
+        token_descriptor("TKN", token, 18)[:25] + valid[25:],
+        # Signature of the descriptor without its tag
+        valid[:25] + TOKEN_SIGNER_KEY.sign_deterministic(valid[:25], hashfunc=sha256, sigencode=sigencode_der),
+        # Ticker too long
+        token_descriptor("TOOLONGTICK", token, 6),
+        # Space in the ticker
+        token_descriptor("T N", token, 6),
+        # Too many decimals
+        token_descriptor("TKN", token, 33),
+        # No signature
+        valid[:25],
+    ]
+    for descriptor in descriptors:
+        assert provide_token_info(client, descriptor).status == Errors.SW_INCORRECT_DATA
+
+
+# In this test we fill the token cache
+def test_provide_token_info_full(backend):
+    client = VechainClient(backend)
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+
+    for i in range(8):
+        address = bytes([i + 1]) * 20
+        assert provide_token_info(client, token_descriptor(f"TKN{i}", address, 18)).status == 0x9000
+    # A token already provided can be provided again
+    assert provide_token_info(client, token_descriptor("TKN", bytes([1]) * 20, 18)).status == 0x9000
+    rapdu = provide_token_info(client, token_descriptor("TKN9", token, 18))
+    assert rapdu.status == Errors.SW_NOT_ENOUGH_MEMORY_SPACE
@@ -1,3 +1,4 @@
+import json
 import struct
 from hashlib import blake2b
 from ragger.backend import RaisePolicy, SpeculosBackend
@@ -5,8 +6,8 @@ from ragger.navigator import NavInsID
 from utils import ROOT_SCREENSHOT_PATH, check_signature_validity
 from vechain_client import VechainClient, Errors, unpack_get_public_key_response
 
- # Certificate to sign (Json format)
-CERTIFICATE_TO_SIGN = str({
+ # Certificate to sign (canonical Json format: sorted keys, no whitespace)
+CERTIFICATE_TO_SIGN = json.dumps({
                             'purpose': 'identification',
                             'payload': {
                                 'type': 'text',
@@ -14,7 +15,7 @@ CERTIFICATE_TO_SIGN = str({
                             },
                             'domain': 'localhost',
                             'timestamp': 15035330,
-                        })
+                        }, sort_keys=True, separators=(',', ':'))
 
 # The path used for all tests
 path: str = "m/44'/818'/0'/0/0"
@@ -64,12 +65,12 @@ def test_sign_certificate(firmware, backend, navigator, test_name):
         else:
             # check that the certificate hash computed on device is the same as the
             # reference one (check only the first displayed digits)
-            navigator.navigate_and_compare(ROOT_SCREENSHOT_PATH, test_name,[
-                NavInsID.USE_CASE_REVIEW_TAP,
-                NavInsID.USE_CASE_REVIEW_TAP,
-                NavInsID.USE_CASE_REVIEW_CONFIRM,
-                NavInsID.USE_CASE_STATUS_DISMISS
-            ])
+            navigator.navigate_until_text_and_compare(NavInsID.USE_CASE_REVIEW_TAP,
+                                                      [NavInsID.USE_CASE_REVIEW_CONFIRM,
+                                                       NavInsID.USE_CASE_STATUS_DISMISS],
+                                                      "Hold to sign",
+                                                      ROOT_SCREENSHOT_PATH,
+                                                      test_name)
     # The device as yielded the result, parse it and ensure that the signature is correct
     response = client.get_async_response().data
 
@@ -233,12 +234,10 @@ def test_sign_random_certificate(firmware, backend, navigator, test_name):
                                                 screen_change_before_first_instruction=False)
             else:
                 # working with stax and flex 
-                navigator.navigate([
-                    NavInsID.USE_CASE_REVIEW_TAP,
-                    NavInsID.USE_CASE_REVIEW_TAP,
-                    NavInsID.USE_CASE_REVIEW_CONFIRM,
-                    NavInsID.USE_CASE_STATUS_DISMISS
-                ])
+                navigator.navigate_until_text(NavInsID.USE_CASE_REVIEW_TAP,
+                                              [NavInsID.USE_CASE_REVIEW_CONFIRM,
+                                               NavInsID.USE_CASE_STATUS_DISMISS],
+                                              "Hold to sign")
 
 
         # The device as yielded the result, parse it and ensure that the signature is correct
@@ -246,3 +245,41 @@ def test_sign_random_certificate(firmware, backend, navigator, test_name):
 
         if isinstance(backend, SpeculosBackend):
             assert check_signature_validity(public_key, response, message_encoded)
+
+
+# In this test we send to the device certificates which are not canonical Json, or miss a field,
+# and ensure they are rejected before any review
+def test_sign_certificate_not_canonical(backend):
+    certificates = [
+        # Python representation, not Json
+        str(json.loads(CERTIFICATE_TO_SIGN)),
+        # Whitespace
+        json.dumps(json.loads(CERTIFICATE_TO_SIGN), sort_keys=True),
+        # Unsorted keys
+        json.dumps(json.loads(CERTIFICATE_TO_SIGN), separators=(',', ':')),
+        # Missing timestamp
+        '{"domain":"localhost","payload":{"content":"fyi","type":"text"},"purpose":"identification"}',
+        # Uppercase signer
+        '{"domain":"localhost","payload":{"content":"fyi","type":"text"},"purpose":"identification",'
+        '"signer":"0xF077B491B355E64048CE21E3A6FC4751EEEA77FA","timestamp":15035330}',
+        # Trailing data
+        CERTIFICATE_TO_SIGN + ' ',
+    ]
+    # Use the app interface instead of raw interface
+    client = VechainClient(backend)
+
+    # Disable raising when trying to unpack an error APDU
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+
+    for cert in certificates:
+        message_encoded = cert.encode()
+        message_bytes = struct.pack(">I", len(message_encoded))
+        message_bytes += message_encoded
+
+        # The certificate is rejected while it is received, without any review
+        with client.sign_certificate(path=path, data=message_bytes):
+            pass
+        response = client.get_async_response()
+
+        assert response.status == Errors.SW_INCORRECT_DATA
+        assert len(response.data) == 0
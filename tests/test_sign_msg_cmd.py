@@ -244,4 +244,45 @@ def test_sign_random_message(firmware, backend, navigator, test_name):
 
         if isinstance(backend, SpeculosBackend):
             assert check_signature_validity(public_key, response, toPersonalMessage(msg))
-    
\ No newline at end of file
+    
+# In this test we send to the device a binary message longer than its preview, sent in several blocks:
+# its leading bytes are displayed in hex, followed by the message hash
+def test_sign_message_long_binary(firmware, backend, navigator, test_name):
+    # Use the app interface instead of raw interface
+    client = VechainClient(backend)
+
+    message = bytes(range(256)) * 2
+    preview = message[:4].hex().upper()
+
+    hash_msg = blake2b(digest_size=32)
+    hash_msg.update(b"\x19VeChain Signed Message:\n" + str(len(message)).encode() + message)
+    hash_part_to_check = hash_msg.digest().hex()[:4]
+
+    # get public key from device
+    response = client.get_public_key(path=path).data
+    _, public_key = unpack_get_public_key_response(response)
+
+    with client.sign_message_long(path=path, data=struct.pack(">I", len(message)) + message):
+        if firmware.device.startswith("nano"):
+            navigator.navigate_until_text(NavInsID.RIGHT_CLICK,
+                                            [],
+                                            preview,
+                                            screen_change_after_last_instruction=False)
+            navigator.navigate_until_text(NavInsID.RIGHT_CLICK,
+                                            [],
+                                            str(hash_part_to_check).upper(),
+                                            screen_change_before_first_instruction=False,
+                                            screen_change_after_last_instruction=False)
+            navigator.navigate_until_text(NavInsID.RIGHT_CLICK,
+                                            [NavInsID.BOTH_CLICK],
+                                            "Sign",
+                                            screen_change_before_first_instruction=False)
+        else:
+            navigator.navigate_until_text(NavInsID.USE_CASE_REVIEW_TAP,
+                                            [NavInsID.USE_CASE_REVIEW_CONFIRM],
+                                            "Hold to sign")
+    response = client.get_async_response().data
+
+    if isinstance(backend, SpeculosBackend):
+        assert check_signature_validity(public_key, response,
+                                        b"\x19VeChain Signed Message:\n" + str(len(message)).encode() + message)
@@ -0,0 +1,71 @@
+from ragger.navigator import NavInsID
+from ragger.backend import RaisePolicy, SpeculosBackend
+from ragger.bip import pack_derivation_path
+from utils import check_signature_validity
+from vechain_client import VechainClient, Errors, CLA, InsType, P1, P2, unpack_get_public_key_response
+
+# Same transaction as in test_sign_tx_cmd.py
+transaction : bytes = bytes.fromhex("f83a81aa88aae47d18daa1301d8202d0e0df94d6fdbeb6d0fbc690dabd352cf93b2f8d782a46b5884563918244f4000080818082520880821234c0")
+
+# The path used for all tests
+path: str = "m/44'/818'/0'/0/0"
+other_path: str = "m/44'/818'/0'/0/1"
+
+
+# In this test queries, including failing ones, are interleaved with the data blocks of a transaction
+# The signing session is not disturbed by them
+def test_sign_session_interleaved_queries(firmware, backend, navigator):
+    client = VechainClient(backend)
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+
+    response = client.get_public_key(path=path).data
+    _, public_key = unpack_get_public_key_response(response)
+
+    rapdu = backend.exchange(cla=CLA, ins=InsType.INS_SIGN, p1=P1.P1_START, p2=P2.P2_LAST,
+                             data=pack_derivation_path(path) + transaction[:20])
+    assert rapdu.status == 0x9000
+
+    # Address lookup of another account
+    assert client.get_public_key(path=other_path).status == 0x9000
+    # Failing query
+    rapdu = backend.exchange(cla=CLA, ins=InsType.INS_GET_PUBLIC_KEY, p1=0x05, p2=0x00,
+                             data=pack_derivation_path(other_path))
+    assert rapdu.status != 0x9000
+    client.get_app_configuration()
+
+    with backend.exchange_async(cla=CLA, ins=InsType.INS_SIGN, p1=P2.P2_MORE, p2=P2.P2_LAST,
+                                data=transaction[20:]):
+        if firmware.device.startswith("nano"):
+            navigator.navigate_until_text(NavInsID.RIGHT_CLICK,
+                                          [NavInsID.BOTH_CLICK],
+                                          "Accept")
+        else:
+            navigator.navigate([
+                NavInsID.USE_CASE_REVIEW_TAP,
+                NavInsID.USE_CASE_REVIEW_TAP,
+                NavInsID.USE_CASE_REVIEW_CONFIRM,
+                NavInsID.USE_CASE_STATUS_DISMISS
+            ])
+
+    response = client.get_async_response().data
+    if isinstance(backend, SpeculosBackend):
+        assert check_signature_validity(public_key, response, transaction)
+
+
+# A data block cannot continue the session of another signing instruction
+def test_sign_session_wrong_owner(backend):
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+
+    message = b"Hello"
+    rapdu = backend.exchange(cla=CLA, ins=InsType.INS_SIGN_PERSONAL_MESSAGE, p1=P1.P1_START, p2=P2.P2_LAST,
+                             data=pack_derivation_path(path) + len(message + b" world").to_bytes(4, "big") + message)
+    assert rapdu.status == 0x9000
+
+    rapdu = backend.exchange(cla=CLA, ins=InsType.INS_SIGN, p1=P2.P2_MORE, p2=P2.P2_LAST,
+                             data=transaction[20:])
+    assert rapdu.status == Errors.SW_TRANSACTION_CANCELLED
+
+    # The message session is still running
+    rapdu = backend.exchange(cla=CLA, ins=InsType.INS_SIGN_PERSONAL_MESSAGE, p1=P2.P2_MORE, p2=P2.P2_LAST,
+                             data=b" wor")
+    assert rapdu.status == 0x9000
@@ -1,6 +1,6 @@
 from ragger.navigator import NavInsID, NavIns
 from ragger.backend import RaisePolicy, SpeculosBackend
-from utils import ROOT_SCREENSHOT_PATH, check_signature_validity,settingEnables
+from utils import ROOT_SCREENSHOT_PATH, check_signature_validity,settingEnables,expertModeEnables
 from vechain_client import VechainClient, Errors, unpack_get_public_key_response
 
 # Tests inputs (transactions) have been generated with tests/legacy/apdu_generator.py
@@ -381,3 +381,44 @@ def test_sign_random_multi_clause_tx(firmware, backend, navigator, test_name):
 
         if isinstance(backend, SpeculosBackend):
             assert check_signature_validity(public_key, response, encoded)
+
+# Transaction calling approve(0xd6FdBEB6d0FBC690DaBD352cF93b2f8D782A46B5, 1e18) with two extra
+# words: 132 bytes of data, the last word being only hashed by the device
+transaction_expert_data : bytes = bytes.fromhex("f8b881aa88aae47d18daa1301d8202d0f89ef89c94d6fdbeb6d0fbc690dabd352cf93b2f8d782a46b580b884095ea7b3000000000000000000000000d6fdbeb6d0fbc690dabd352cf93b2f8d782a46b50000000000000000000000000000000000000000000000000de0b6b3a7640000000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f818082c35080821234c0")
+
+# In this test we enable the expert mode and send a transaction with data: its selector, its
+# length, its first words and the hash of the whole data are reviewed before signing it
+def test_sign_tx_expert_data(firmware, backend, navigator, test_name):
+    # Use the app interface instead of raw interface
+    client = VechainClient(backend)
+
+    # get public key from device
+    response = client.get_public_key(path=path).data
+    _, public_key = unpack_get_public_key_response(response)
+    settingEnables(firmware.device,navigator.navigate,NavInsID,NavIns)
+    expertModeEnables(firmware.device,navigator.navigate,NavInsID,NavIns)
+
+    with client.sign_tx(path=path, transaction=transaction_expert_data):
+        if firmware.device.startswith("nano"):
+            navigator.navigate_until_text(NavInsID.RIGHT_CLICK,
+                                            [],
+                                            "Data hash",
+                                            screen_change_before_first_instruction=False)
+            navigator.navigate_until_text(NavInsID.RIGHT_CLICK,
+                                            [NavInsID.BOTH_CLICK],
+                                            "Accept",
+                                            screen_change_before_first_instruction=False)
+        else:
+            navigator.navigate([NavInsID.USE_CASE_CHOICE_CONFIRM])
+            navigator.navigate_until_text(NavInsID.USE_CASE_REVIEW_TAP,
+                                          [],
+                                          "Data hash")
+            navigator.navigate_until_text(NavInsID.USE_CASE_REVIEW_TAP,
+                                          [NavInsID.USE_CASE_REVIEW_CONFIRM,
+                                           NavInsID.USE_CASE_STATUS_DISMISS],
+                                          "Hold to sign")
+    # The device as yielded the result, parse it and ensure that the signature is correct
+    response = client.get_async_response().data
+
+    if isinstance(backend, SpeculosBackend):
+        assert check_signature_validity(public_key, response, transaction_expert_data)
@@ -0,0 +1,56 @@
+from hashlib import blake2b
+from ragger.navigator import NavInsID
+from ragger.backend import RaisePolicy, SpeculosBackend
+from utils import check_signature_validity
+from vechain_client import VechainClient, Errors, unpack_get_public_key_response
+
+# Same transaction as in test_sign_tx_cmd.py, with reserved.features = 1 (fee delegation)
+transaction : bytes = bytes.fromhex("f83a81aa88aae47d18daa1301d8202d0e0df94d6fdbeb6d0fbc690dabd352cf93b2f8d782a46b5884563918244f4000080818082520880821234c101")
+# Same transaction without any reserved feature
+transaction_no_delegation : bytes = bytes.fromhex("f83a81aa88aae47d18daa1301d8202d0e0df94d6fdbeb6d0fbc690dabd352cf93b2f8d782a46b5884563918244f4000080818082520880821234c0")
+
+# Sender of the transaction
+origin : bytes = bytes.fromhex("7567d83b7b8d80addcb281a71d54fc7b3364ffed")
+
+# The path used for all tests
+path: str = "m/44'/818'/0'/0/0"
+
+
+# In this test we sign a transaction as its gas payer
+# The signature covers blake2b(signingHash || origin)
+def test_sign_tx_delegation(firmware, backend, navigator):
+    client = VechainClient(backend)
+
+    response = client.get_public_key(path=path).data
+    _, public_key = unpack_get_public_key_response(response)
+
+    with client.sign_tx_delegation(path=path, origin=origin, transaction=transaction):
+        if firmware.device.startswith("nano"):
+            navigator.navigate_until_text(NavInsID.RIGHT_CLICK,
+                                          [NavInsID.BOTH_CLICK],
+                                          "Accept")
+        else:
+            navigator.navigate([
+                NavInsID.USE_CASE_REVIEW_TAP,
+                NavInsID.USE_CASE_REVIEW_TAP,
+                NavInsID.USE_CASE_REVIEW_CONFIRM,
+                NavInsID.USE_CASE_STATUS_DISMISS
+            ])
+
+    response = client.get_async_response().data
+
+    signing_hash = blake2b(transaction, digest_size=32).digest()
+    if isinstance(backend, SpeculosBackend):
+        assert check_signature_validity(public_key, response, signing_hash + origin)
+
+
+# The transaction must enable fee delegation
+def test_sign_tx_delegation_not_enabled(backend):
+    client = VechainClient(backend)
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+
+    with client.sign_tx_delegation(path=path, origin=origin, transaction=transaction_no_delegation):
+        pass
+
+    response = client.get_async_response()
+    assert response.status == Errors.SW_INCORRECT_DATA
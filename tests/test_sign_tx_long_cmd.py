@@ -1,7 +1,9 @@
+import pytest
+from ragger.bip import pack_derivation_path
 from ragger.navigator import NavInsID, NavIns
 from ragger.backend import RaisePolicy, SpeculosBackend
-from utils import ROOT_SCREENSHOT_PATH,settingEnables
-from vechain_client import VechainClient, Errors
+from utils import ROOT_SCREENSHOT_PATH, check_signature_validity, settingEnables
+from vechain_client import VechainClient, Errors, CLA, InsType, P1, P2, split_tx, unpack_get_public_key_response
 
 # Tests inputs (transactions) have been generated with tests/generatetx.py
 # Input
@@ -13,20 +15,12 @@ ref_signature2: bytes = bytes.fromhex("ddc9bd29343f67c6193c16bcca77e27ef63da70ad
 # The path used for all tests
 path: str = "m/44'/818'/0'/0/0"
 
-# In this test we send to the device a transaction to sign and validate it on screen
-# The transaction is long and will be sent in multiple chunk
-# We will ensure that the displayed information is correct by using screenshots comparison
-def test_sign_tx_long_tx(firmware, backend, navigator, test_name):
-    # Use the app interface instead of raw interface
-    client = VechainClient(backend)
-    settingEnables(firmware.device,navigator.navigate,NavInsID,NavIns)
-
-    # As it requires on-screen validation, the function is asynchronous 
-    # Instructions are different between nano and stax.
-    # Both will yield the result when the navigation is done
-    if firmware.device.startswith("nano"):
-        # send the transaction
-        with client.sing_tx_long(path=path, transaction=transaction):
+# On Nano devices, each clause is reviewed before the next one is parsed: the review starts
+# with the block completing the first clause, and a block is replied once its clauses are reviewed
+def review_clauses_nano(client, navigator, transaction, first_clause_block):
+    last_block = len(split_tx(path, transaction)) - 1
+    for block in client.sign_tx_blocks(path=path, transaction=transaction):
+        if block == first_clause_block:
             navigator.navigate_until_text(NavInsID.RIGHT_CLICK,
                                             [NavInsID.BOTH_CLICK],
                                             "Data present",
@@ -35,15 +29,39 @@ def test_sign_tx_long_tx(firmware, backend, navigator, test_name):
                                             [NavInsID.BOTH_CLICK],
                                             "Multiple Clauses",
                                             screen_change_before_first_instruction=False)
-
+        if block == last_block:
             navigator.navigate_until_text(NavInsID.RIGHT_CLICK,
                                             [NavInsID.BOTH_CLICK],
                                             "Accept",
                                             screen_change_before_first_instruction=False)
+        elif block >= first_clause_block:
+            # Reviewing the last clause of the block sends its reply
+            navigator.navigate_until_text(NavInsID.RIGHT_CLICK,
+                                            [],
+                                            "Loading",
+                                            screen_change_before_first_instruction=False,
+                                            screen_change_after_last_instruction=False)
+
+# In this test we send to the device a transaction to sign and validate it on screen
+# The transaction is long and will be sent in multiple chunk
+# We will ensure that the displayed information is correct by using screenshots comparison
+def test_sign_tx_long_tx(firmware, backend, navigator, test_name):
+    # Use the app interface instead of raw interface
+    client = VechainClient(backend)
+    settingEnables(firmware.device,navigator.navigate,NavInsID,NavIns)
+
+    # As it requires on-screen validation, the function is asynchronous 
+    # Instructions are different between nano and stax.
+    # Both will yield the result when the navigation is done
+    if firmware.device.startswith("nano"):
+        # The first clause ends in the third block
+        review_clauses_nano(client, navigator, transaction, 2)
     else:
         # send the transaction
+        # The review is streamed: the clauses are displayed as they are parsed, after the warning
         with client.sing_tx_long(path=path, transaction=transaction):
-            navigator.navigate([NavInsID.USE_CASE_CHOICE_CONFIRM])
+            navigator.navigate([NavInsID.USE_CASE_CHOICE_CONFIRM],
+                               screen_change_before_first_instruction=False)
             navigator.navigate_until_text_and_compare(NavInsID.USE_CASE_REVIEW_TAP,
                 [NavInsID.USE_CASE_REVIEW_CONFIRM,
                 NavInsID.USE_CASE_STATUS_DISMISS,],
@@ -61,21 +79,8 @@ def test_sign_tx_long_tx(firmware, backend, navigator, test_name):
     
     # send a second transaction without restarting the test
     if firmware.device.startswith("nano"):
-        with client.sing_tx_long(path=path, transaction=transaction2):
-            navigator.navigate_until_text(NavInsID.RIGHT_CLICK,
-                                            [NavInsID.BOTH_CLICK],
-                                            "Data present",
-                                            screen_change_before_first_instruction=False)
-            navigator.navigate_until_text(NavInsID.RIGHT_CLICK,
-                                            [NavInsID.BOTH_CLICK],
-                                            "Multiple Clauses",
-                                            screen_change_before_first_instruction=False)
-
-            navigator.navigate_until_text(NavInsID.RIGHT_CLICK,
-                                            [NavInsID.BOTH_CLICK],
-                                            "Accept",
-                                            screen_change_before_first_instruction=False)
-
+        # The first clause ends in the first block
+        review_clauses_nano(client, navigator, transaction2, 0)
     else:
         # send the transaction
         with client.sing_tx_long(path=path, transaction=transaction2):
@@ -84,6 +89,8 @@ def test_sign_tx_long_tx(firmware, backend, navigator, test_name):
                 NavInsID.USE_CASE_CHOICE_CONFIRM,
                 NavInsID.USE_CASE_REVIEW_TAP,
                 NavInsID.USE_CASE_REVIEW_TAP,
+                NavInsID.USE_CASE_REVIEW_TAP,
+                NavInsID.USE_CASE_REVIEW_TAP,
                 NavInsID.USE_CASE_REVIEW_CONFIRM,
                 NavInsID.USE_CASE_STATUS_DISMISS,
             ])
@@ -93,4 +100,113 @@ def test_sign_tx_long_tx(firmware, backend, navigator, test_name):
     
     # check the signature
     if isinstance(backend, SpeculosBackend):
-        assert ref_signature2 == response
\ No newline at end of file
+        assert ref_signature2 == response
+
+# 20 empty clauses padding a transfer of 5 VET, all in a single data block
+transaction_padded : bytes = bytes.fromhex("f88a81aa88aae47d18daa1301d8202d0f870" + "c3808080" * 20 + "df94d6fdbeb6d0fbc690dabd352cf93b2f8d782a46b5884563918244f4000080818082520880821234c0")
+
+# In this test a single data block completes more clauses than the review holds at once:
+# the parser stops until the user has reviewed the first ones, so that the last clause is displayed
+def test_sign_tx_many_clauses_in_block(firmware, backend, navigator):
+    client = VechainClient(backend)
+    settingEnables(firmware.device,navigator.navigate,NavInsID,NavIns)
+
+    response = client.get_public_key(path=path).data
+    _, public_key = unpack_get_public_key_response(response)
+
+    with client.sign_tx(path=path, transaction=transaction_padded):
+        if firmware.device.startswith("nano"):
+            navigator.navigate_until_text(NavInsID.RIGHT_CLICK,
+                                            [NavInsID.BOTH_CLICK],
+                                            "Multiple Clauses")
+            navigator.navigate_until_text(NavInsID.RIGHT_CLICK,
+                                            [],
+                                            "(21)",
+                                            screen_change_before_first_instruction=False)
+            navigator.navigate_until_text(NavInsID.RIGHT_CLICK,
+                                            [NavInsID.BOTH_CLICK],
+                                            "Accept",
+                                            screen_change_before_first_instruction=False)
+        else:
+            navigator.navigate([NavInsID.USE_CASE_CHOICE_CONFIRM])
+            navigator.navigate_until_text(NavInsID.USE_CASE_REVIEW_TAP,
+                                            [],
+                                            "21",
+                                            screen_change_before_first_instruction=False)
+            navigator.navigate_until_text(NavInsID.USE_CASE_REVIEW_TAP,
+                                            [NavInsID.USE_CASE_REVIEW_CONFIRM,
+                                            NavInsID.USE_CASE_STATUS_DISMISS],
+                                            "Hold to sign",
+                                            screen_change_before_first_instruction=False)
+
+    response = client.get_async_response().data
+    if isinstance(backend, SpeculosBackend):
+        assert check_signature_validity(public_key, response, transaction_padded)
+
+# In this test we check that the commands displaying a review are refused while a transaction
+# is reviewed as it is streamed, the review keeping the screen
+def test_sign_tx_long_screen_kept(firmware, backend):
+    if firmware.device.startswith("nano"):
+        # The clause review of Nano devices starts with the block completing the first clause
+        pytest.skip("The review is not streamed from the first block on Nano devices")
+    client = VechainClient(backend)
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+
+    chunks = split_tx(path, transaction)
+    assert client.sign_tx_chunk(chunks[0], first=True).status == 0x9000
+
+    rapdu = backend.exchange(cla=CLA,
+                             ins=InsType.INS_GET_PUBLIC_KEY,
+                             p1=P1.P1_CONFIRM,
+                             p2=P2.P2_LAST,
+                             data=pack_derivation_path(path))
+    assert rapdu.status == Errors.SW_TRANSACTION_CANCELLED
+    rapdu = client.address_book(P1.P1_ADDRESS_BOOK_REMOVE, bytes.fromhex("d6fdbeb6d0fbc690dabd352cf93b2f8d782a46b5"))
+    assert rapdu.status == Errors.SW_TRANSACTION_CANCELLED
+
+    # The queries without review are still answered
+    assert client.get_public_key(path=path).status == 0x9000
+
+# In this test we reject the transaction while the next clause is loading: the following
+# blocks are refused
+def test_sign_tx_long_reject_while_loading(firmware, backend, navigator):
+    client = VechainClient(backend)
+    settingEnables(firmware.device,navigator.navigate,NavInsID,NavIns)
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+
+    chunks = split_tx(path, transaction)
+    if firmware.device.startswith("nano"):
+        # The first clause ends in the third block, replied once the clause is reviewed
+        for i in range(2):
+            assert client.sign_tx_chunk(chunks[i], first=(i == 0)).status == 0x9000
+        with backend.exchange_async(cla=CLA,
+                                    ins=InsType.INS_SIGN,
+                                    p1=P2.P2_MORE,
+                                    p2=P2.P2_LAST,
+                                    data=chunks[2]):
+            navigator.navigate_until_text(NavInsID.RIGHT_CLICK,
+                                            [NavInsID.BOTH_CLICK],
+                                            "Data present")
+            navigator.navigate_until_text(NavInsID.RIGHT_CLICK,
+                                            [NavInsID.BOTH_CLICK],
+                                            "Multiple Clauses",
+                                            screen_change_before_first_instruction=False)
+            navigator.navigate_until_text(NavInsID.RIGHT_CLICK,
+                                            [],
+                                            "Loading",
+                                            screen_change_before_first_instruction=False,
+                                            screen_change_after_last_instruction=False)
+        assert client.get_async_response().status == 0x9000
+        navigator.navigate_until_text(NavInsID.RIGHT_CLICK,
+                                        [NavInsID.BOTH_CLICK],
+                                        "Reject",
+                                        screen_change_before_first_instruction=False)
+    else:
+        # The review waits for the first clause, which ends in the third block
+        assert client.sign_tx_chunk(chunks[0], first=True).status == 0x9000
+        navigator.navigate([NavInsID.USE_CASE_CHOICE_REJECT,
+                            NavInsID.USE_CASE_STATUS_DISMISS],
+                           screen_change_before_first_instruction=False)
+
+    rapdu = client.sign_tx_chunk(chunks[3], first=False)
+    assert rapdu.status == Errors.SW_TRANSACTION_CANCELLED
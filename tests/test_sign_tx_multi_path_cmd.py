@@ -0,0 +1,61 @@
+from ragger.navigator import NavInsID
+from ragger.backend import RaisePolicy, SpeculosBackend
+from utils import check_signature_validity
+from vechain_client import VechainClient, Errors, unpack_get_public_key_response, unpack_sign_multi_path_response
+
+# Same transaction as in test_sign_tx_cmd.py
+transaction : bytes = bytes.fromhex("f83a81aa88aae47d18daa1301d8202d0e0df94d6fdbeb6d0fbc690dabd352cf93b2f8d782a46b5884563918244f4000080818082520880821234c0")
+
+# More paths than signatures fitting in a single response
+paths = [f"m/44'/818'/0'/0/{i}" for i in range(5)]
+
+
+def approve(firmware, navigator):
+    if firmware.device.startswith("nano"):
+        navigator.navigate_until_text(NavInsID.RIGHT_CLICK,
+                                      [NavInsID.BOTH_CLICK],
+                                      "Accept")
+    else:
+        navigator.navigate([
+            NavInsID.USE_CASE_REVIEW_TAP,
+            NavInsID.USE_CASE_REVIEW_TAP,
+            NavInsID.USE_CASE_REVIEW_CONFIRM,
+            NavInsID.USE_CASE_STATUS_DISMISS
+        ])
+
+
+# In this test we sign the same transaction with several paths after a single review
+# The signatures that do not fit in the first response are fetched afterwards
+def test_sign_tx_multi_path(firmware, backend, navigator):
+    client = VechainClient(backend)
+
+    public_keys = []
+    for path in paths:
+        response = client.get_public_key(path=path).data
+        _, public_key = unpack_get_public_key_response(response)
+        public_keys.append(public_key)
+
+    with client.sign_tx_multi_path(paths=paths, transaction=transaction):
+        approve(firmware, navigator)
+
+    remaining, signatures = unpack_sign_multi_path_response(client.get_async_response().data)
+    assert remaining == len(paths) - len(signatures)
+
+    while remaining:
+        remaining, next_signatures = unpack_sign_multi_path_response(client.get_next_signatures().data)
+        signatures += next_signatures
+
+    assert len(signatures) == len(paths)
+    if isinstance(backend, SpeculosBackend):
+        for public_key, signature in zip(public_keys, signatures):
+            assert check_signature_validity(public_key, signature, transaction)
+
+
+# The next signatures can only be fetched right after an approval
+def test_sign_tx_multi_path_next_without_approval(backend):
+    client = VechainClient(backend)
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+
+    response = client.get_next_signatures()
+
+    assert response.status == Errors.SW_TRANSACTION_CANCELLED
@@ -0,0 +1,109 @@
+import sha3
+from hashlib import blake2b
+from ragger.navigator import NavInsID
+from ragger.backend import RaisePolicy, SpeculosBackend
+from utils import check_signature_validity
+from vechain_client import VechainClient, Errors, unpack_get_public_key_response, unpack_sign_sequence_response
+
+# Same transaction as in test_sign_tx_cmd.py, with a 32 bytes dependsOn and a given nonce
+def build_transaction(depends_on: bytes, nonce: int) -> bytes:
+    body = bytes.fromhex("81aa88aae47d18daa1301d8202d0e0df94d6fdbeb6d0fbc690dabd352cf93b2f8d782a46b5884563918244f40000808180825208")
+    body += (bytes([0xa0]) + depends_on) if depends_on else bytes([0x80])
+    body += bytes([0x82]) + nonce.to_bytes(2, byteorder='big')
+    body += bytes([0xc0])
+    return bytes([0xf8, len(body)]) + body
+
+PLACEHOLDER : bytes = bytes(32)
+
+# The path used for all tests
+path: str = "m/44'/818'/0'/0/0"
+
+
+def tx_id(signing_hash: bytes, signer: bytes) -> bytes:
+    return blake2b(signing_hash + signer, digest_size=32).digest()
+
+
+# In this test we sign three transactions, each one depending on the previous one
+# The device fills in dependsOn and returns the signatures along with the transaction IDs
+def test_sign_tx_sequence(firmware, backend, navigator):
+    client = VechainClient(backend)
+
+    response = client.get_public_key(path=path).data
+    _, public_key = unpack_get_public_key_response(response)
+    signer = sha3.keccak_256(public_key[1:]).digest()[-20:]
+
+    transactions = [
+        build_transaction(None, 0x1234),
+        build_transaction(PLACEHOLDER, 0x1235),
+        build_transaction(PLACEHOLDER, 0x1236),
+    ]
+
+    # The recipient and the total of the sequence are reviewed before its approval
+    with client.sign_tx_sequence(path=path, transactions=transactions):
+        if firmware.device.startswith("nano"):
+            navigator.navigate_until_text(NavInsID.RIGHT_CLICK,
+                                          [],
+                                          "To")
+            navigator.navigate_until_text(NavInsID.RIGHT_CLICK,
+                                          [],
+                                          "Total")
+            navigator.navigate_until_text(NavInsID.RIGHT_CLICK,
+                                          [NavInsID.BOTH_CLICK],
+                                          "Accept",
+                                          screen_change_before_first_instruction=False)
+        else:
+            navigator.navigate_until_text(NavInsID.USE_CASE_REVIEW_TAP,
+                                          [],
+                                          "Total")
+            navigator.navigate_until_text(NavInsID.USE_CASE_REVIEW_TAP,
+                                          [NavInsID.USE_CASE_REVIEW_CONFIRM,
+                                           NavInsID.USE_CASE_STATUS_DISMISS],
+                                          "Hold to sign",
+                                          screen_change_before_first_instruction=False)
+
+    remaining, records = unpack_sign_sequence_response(client.get_async_response().data)
+    assert remaining == 1
+    assert len(records) == 2
+    remaining, next_records = unpack_sign_sequence_response(client.get_next_signatures().data)
+    assert remaining == 0
+    records += next_records
+    assert len(records) == 3
+
+    # Rebuild the chain as the network sees it
+    depends_on = None
+    for index, (signature, transaction_id) in enumerate(records):
+        transaction = build_transaction(depends_on, 0x1234 + index)
+        signing_hash = blake2b(transaction, digest_size=32).digest()
+        assert transaction_id == tx_id(signing_hash, signer)
+        if index < len(records) - 1:
+            assert client.sequence_tx_ids[index] == transaction_id
+        if isinstance(backend, SpeculosBackend):
+            assert check_signature_validity(public_key, signature, transaction)
+        depends_on = transaction_id
+
+
+# The transactions following the first one must carry a 32 bytes dependsOn placeholder
+def test_sign_tx_sequence_missing_placeholder(backend):
+    client = VechainClient(backend)
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+
+    transactions = [
+        build_transaction(None, 0x1234),
+        build_transaction(None, 0x1235),
+    ]
+
+    with client.sign_tx_sequence(path=path, transactions=transactions):
+        pass
+
+    response = client.get_async_response()
+    assert response.status == Errors.SW_INCORRECT_DATA
+
+
+# A sequence cannot be continued once the previous transaction has not been sent
+def test_sign_tx_sequence_next_without_first(backend):
+    client = VechainClient(backend)
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+
+    rapdu = backend.exchange(cla=0xE0, ins=0x04, p1=0x01, p2=0x03,
+                             data=build_transaction(PLACEHOLDER, 0x1235))
+    assert rapdu.status == Errors.SW_TRANSACTION_CANCELLED
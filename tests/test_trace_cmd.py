@@ -0,0 +1,22 @@
+import pytest
+from ragger.backend import RaisePolicy
+from vechain_client import VechainClient, InsType
+from trace_decode import decode_page, TRACE_EVENTS
+
+
+# In this test we read back the events of a configuration request from a TRACE=1 build
+def test_trace(backend):
+    client = VechainClient(backend)
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+
+    rapdu = client.get_trace(clear=True)
+    if rapdu.status == 0x6D00:
+        pytest.skip("The application is not built with TRACE=1")
+
+    client.get_app_configuration()
+
+    count, records = decode_page(client.get_trace().data)
+    events = [(TRACE_EVENTS[event], arg0, arg1) for event, arg0, arg1, _ in records]
+    assert ("APDU", InsType.INS_GET_APP_CONFIGURATION, 0) in events
+    assert ("APDU_DONE", 0, 0x9000) in events
+    assert count == len(records)
@@ -0,0 +1,92 @@
+# Decode the event trace of a TRACE=1 build, read with INS 0x0C (GET_TRACE)
+#
+# Usage: python3 trace_decode.py <page 0 response hex> [<page 1 response hex> ...]
+#        or the responses, one per line, on stdin
+import sys
+from typing import List, Tuple
+
+RECORD_LENGTH = 8
+RECORDS_PER_PAGE = 30
+
+# Keep in sync with traceEvent_e in common/vetTrace.h
+TRACE_EVENTS = [
+    "NONE",
+    "APDU",
+    "APDU_DONE",
+    "TX_FIELD",
+    "CLAUSE",
+    "PARSE_ERROR",
+    "TX_RESULT",
+    "HASH_DONE",
+    "FORMAT_DONE",
+    "SIGN_DONE",
+]
+
+# rlpTxField_e in common/vetUstream.h
+TX_FIELDS = ["NONE", "CONTENT", "CHAINTAG", "BLOCKREF", "EXPIRATION", "CLAUSES", "GASPRICECOEF",
+             "GAS", "DEPENDSON", "NONCE", "RESERVED", "DONE"]
+
+PARSE_ERRORS = ["", "PRE_DECODE", "PRE_DECODE_LOGIC", "DECODE", "CONTEXT"]
+TX_RESULTS = ["PROCESSING", "FINISHED", "FAULT"]
+# reviewValue_e in src/main.h
+REVIEW_VALUES = ["address", "amount", "fee"]
+
+
+def decode_page(page: bytes) -> Tuple[int, List[Tuple[int, int, int, int]]]:
+    count = int.from_bytes(page[:4], byteorder='big')
+    records = []
+    for x in range(4, len(page), RECORD_LENGTH):
+        record = page[x:x + RECORD_LENGTH]
+        records.append((record[0],
+                        record[1],
+                        int.from_bytes(record[2:4], byteorder='big'),
+                        int.from_bytes(record[4:8], byteorder='big')))
+    return count, records
+
+
+def decode_pages(pages: List[bytes]) -> Tuple[int, List[Tuple[int, int, int, int]]]:
+    count = 0
+    records = []
+    for page in pages:
+        count, page_records = decode_page(page)
+        records += page_records
+    return count, records
+
+
+def describe(event: int, arg0: int, arg1: int) -> str:
+    name = TRACE_EVENTS[event] if event < len(TRACE_EVENTS) else f"EVENT_{event}"
+    if name == "APDU":
+        return f"{name} ins={arg0:02x} lc={arg1}"
+    if name == "APDU_DONE":
+        return f"{name} sw={arg1:04x}"
+    if name == "TX_FIELD":
+        field = TX_FIELDS[arg0] if arg0 < len(TX_FIELDS) else str(arg0)
+        return f"{name} {field} length={arg1}"
+    if name == "CLAUSE":
+        return f"{name} #{arg0} length={arg1}"
+    if name == "PARSE_ERROR":
+        error = PARSE_ERRORS[arg1] if arg1 < len(PARSE_ERRORS) else str(arg1)
+        return f"{name} field={arg0} {error}"
+    if name == "TX_RESULT":
+        result = TX_RESULTS[arg0] if arg0 < len(TX_RESULTS) else str(arg0)
+        return f"{name} {result}"
+    if name == "HASH_DONE":
+        return f"{name} hash={arg1:04x}..."
+    if name == "FORMAT_DONE":
+        value = REVIEW_VALUES[arg0] if arg0 < len(REVIEW_VALUES) else str(arg0)
+        return f"{name} {value}"
+    if name == "SIGN_DONE":
+        return f"{name} v={arg0} error={arg1}"
+    return f"{name} {arg0} {arg1}"
+
+
+def main() -> None:
+    lines = sys.argv[1:] if len(sys.argv) > 1 else sys.stdin.read().split()
+    count, records = decode_pages([bytes.fromhex(line) for line in lines])
+    print(f"{count} events recorded, {len(records)} kept")
+    for event, arg0, arg1, sequence in records:
+        print(f"#{sequence:<8d} {describe(event, arg0, arg1)}")
+
+
+if __name__ == "__main__":
+    main()
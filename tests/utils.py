@@ -47,4 +47,30 @@ def settingEnables(device, navigator, NavInsID, NavIns):
             NavIns(NavInsID.TOUCH, (200, 300)),
             NavInsID.USE_CASE_SETTINGS_MULTI_PAGE_EXIT,
             NavInsID.WAIT_FOR_HOME_SCREEN
-        ], screen_change_before_first_instruction=False)
\ No newline at end of file
+        ], screen_change_before_first_instruction=False)
+
+def expertModeEnables(device, navigator, NavInsID, NavIns):
+    if device.startswith("nano"):
+        navigator([
+            NavInsID.RIGHT_CLICK,
+            NavInsID.BOTH_CLICK,
+            NavInsID.RIGHT_CLICK,
+            NavInsID.RIGHT_CLICK,
+            NavInsID.BOTH_CLICK,
+            NavInsID.RIGHT_CLICK,
+            NavInsID.BOTH_CLICK
+        ], screen_change_before_first_instruction=False)
+    elif device.startswith('stax'):
+        navigator([
+            NavInsID.USE_CASE_HOME_SETTINGS,
+            NavIns(NavInsID.TOUCH, (200, 409)),
+            NavInsID.USE_CASE_SETTINGS_MULTI_PAGE_EXIT,
+            NavInsID.WAIT_FOR_HOME_SCREEN
+        ], screen_change_before_first_instruction=False)
+    elif device.startswith('flex'):
+        navigator([
+            NavInsID.USE_CASE_HOME_SETTINGS,
+            NavIns(NavInsID.TOUCH, (200, 487)),
+            NavInsID.USE_CASE_SETTINGS_MULTI_PAGE_EXIT,
+            NavInsID.WAIT_FOR_HOME_SCREEN
+        ], screen_change_before_first_instruction=False)
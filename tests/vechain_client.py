@@ -14,12 +14,26 @@ class P1(IntEnum):
     P1_MAX   = 0x03
     # Parameter 1 for screen confirmation for GET_PUBLIC_KEY.
     P1_CONFIRM = 0x01
+    # Parameter 1 to fetch the next signatures of a multi-path signature.
+    P1_NEXT_SIGNATURES = 0x40
+    # Parameter 1 for the first APDU of the next transaction of a sequence.
+    P1_NEXT_TRANSACTION = 0x01
+    # Parameter 1 to add an entry of the address book.
+    P1_ADDRESS_BOOK_ADD = 0x00
+    # Parameter 1 to remove an entry of the address book.
+    P1_ADDRESS_BOOK_REMOVE = 0x01
 
 class P2(IntEnum):
     # Parameter 2 for last APDU to receive.
     P2_LAST = 0x00
     # Parameter 2 for more APDU to receive.
     P2_MORE = 0x80
+    # Parameter 2 for a multi-path signature of INS_SIGN.
+    P2_SIGN_MULTI_PATH = 0x01
+    # Parameter 2 for a VIP-191 gas payer signature of INS_SIGN.
+    P2_SIGN_DELEGATOR = 0x02
+    # Parameter 2 for a sequence of transactions chained by dependsOn.
+    P2_SIGN_SEQUENCE = 0x03
 
 class InsType(IntEnum):
     INS_GET_PUBLIC_KEY        = 0x02
@@ -27,11 +41,19 @@ class InsType(IntEnum):
     INS_SIGN                  = 0x04
     INS_SIGN_PERSONAL_MESSAGE = 0x08
     INS_SIGN_CERTIFICATE      = 0x09
+    INS_GET_LAST_RESPONSE     = 0x0A
+    INS_GET_STATS             = 0x0B
+    INS_GET_TRACE             = 0x0C
+    INS_ADDRESS_BOOK          = 0x0D
+    INS_PROVIDE_TOKEN_INFO    = 0x0E
 
 class Errors(IntEnum):
     SW_TRANSACTION_CANCELLED  = 0x6985
+    SW_INCORRECT_DATA         = 0x6A80
     SW_NON_ZERO_AMOUNT        = 0x6A87
     SW_UNKNOWN_DESTINATION    = 0x6A88
+    SW_REFERENCED_DATA_NOT_FOUND = 0x6A88
+    SW_NOT_ENOUGH_MEMORY_SPACE = 0x6A84
 
 def split_message(message: bytes, max_size: int) -> List[bytes]:
     return [message[x:x + max_size] for x in range(0, len(message), max_size)]
@@ -40,6 +62,9 @@ def split_tx(path:str, tx:bytes):
     paths = pack_derivation_path(path)
     return split_message(paths + tx, MAX_APDU_LEN)
 
+def pack_derivation_path_list(paths: List[str]) -> bytes:
+    return bytes([len(paths)]) + b"".join(pack_derivation_path(path) for path in paths)
+
 # remainder, data_len, data
 def pop_size_prefixed_buf_from_buf(buffer:bytes) -> Tuple[bytes, int, bytes]:
     data_len = buffer[0]
@@ -71,6 +96,61 @@ def unpack_sign_tx_response(response: bytes) -> Tuple[int, bytes, int]:
 
     return der_sig_len, der_sig, int.from_bytes(buf, byteorder='big')
 
+# Unpack from response:
+# response = remaining (1)
+#            (r (32) s (32) v (1)) * n
+def unpack_sign_multi_path_response(response: bytes) -> Tuple[int, List[bytes]]:
+    remaining = response[0]
+    signatures = split_message(response[1:], 65)
+
+    assert all(len(signature) == 65 for signature in signatures)
+
+    return remaining, signatures
+
+# Unpack from response:
+# response = stack_size (4) stack_used (4)
+def unpack_get_memory_response(response: bytes) -> Tuple[int, int]:
+    assert len(response) == 8
+    return (int.from_bytes(response[0:4], byteorder='big'),
+            int.from_bytes(response[4:8], byteorder='big'))
+
+# Keep in sync with profileStage_e in common/vetProfile.h
+PROFILE_STAGES = ["path", "parse", "hash", "format_amount", "format_fee", "derive", "sign"]
+
+# Unpack from response:
+# response = runs (4) * len(PROFILE_STAGES)
+def unpack_get_profile_response(response: bytes) -> dict:
+    assert len(response) == 4 * len(PROFILE_STAGES)
+    return {stage: int.from_bytes(response[4 * i:4 * i + 4], byteorder='big')
+            for i, stage in enumerate(PROFILE_STAGES)}
+
+# Unpack from response:
+# response = (ins (1) last_error (2) calls (4) bytes_in (4) bytes_out (4) errors (4)) * n
+def unpack_get_stats_response(response: bytes) -> dict:
+    stats = {}
+    for record in split_message(response, 19):
+        assert len(record) == 19
+        values = [int.from_bytes(record[x:x + 4], byteorder='big') for x in range(3, 19, 4)]
+        stats[record[0]] = {
+            "last_error": int.from_bytes(record[1:3], byteorder='big'),
+            "calls": values[0],
+            "bytes_in": values[1],
+            "bytes_out": values[2],
+            "errors": values[3],
+        }
+    return stats
+
+# Unpack from response:
+# response = remaining (1)
+#            (r (32) s (32) v (1) tx_id (32)) * n
+def unpack_sign_sequence_response(response: bytes) -> Tuple[int, List[Tuple[bytes, bytes]]]:
+    remaining = response[0]
+    records = split_message(response[1:], 65 + 32)
+
+    assert all(len(record) == 65 + 32 for record in records)
+
+    return remaining, [(record[:65], record[65:]) for record in records]
+
 class VechainClient:
     def __init__(self, backend: BackendInterface):
         self._backend = backend
@@ -125,6 +205,24 @@ class VechainClient:
                                         data=pack_derivation_path(path)+data) as response:
             yield response
 
+    @contextmanager
+    def sign_message_long(self, path: str, data: bytes) -> Generator[None, None, None]:
+        messages = split_message(pack_derivation_path(path) + data, MAX_APDU_LEN)
+
+        for i in range(0, len(messages) - 1):
+            self._backend.exchange(cla=CLA,
+                                   ins=InsType.INS_SIGN_PERSONAL_MESSAGE,
+                                   p1=P1.P1_START if i == 0 else P2.P2_MORE,
+                                   p2=P2.P2_LAST,
+                                   data=messages[i])
+
+        with self._backend.exchange_async(cla=CLA,
+                                          ins=InsType.INS_SIGN_PERSONAL_MESSAGE,
+                                          p1=P2.P2_MORE,
+                                          p2=P2.P2_LAST,
+                                          data=messages[-1]) as response:
+            yield response
+
     @contextmanager
     def sign_tx(self, path: str, transaction: bytes) -> Generator[None, None, None]:
         with self._backend.exchange_async(cla=CLA,
@@ -155,5 +253,160 @@ class VechainClient:
                                          data=messages[-1]) as response:
             yield response
 
+    def sign_tx_blocks(self, path: str, transaction: bytes) -> Generator[int, None, None]:
+        # Sends the data blocks one at a time, yielding the index of each block while its reply
+        # is pending: on Nano devices, a block completing a clause is replied once reviewed
+        messages = split_tx(path, transaction)
+
+        for i, message in enumerate(messages):
+            with self._backend.exchange_async(cla=CLA,
+                                             ins=InsType.INS_SIGN,
+                                             p1=P1.P1_START if i == 0 else P2.P2_MORE,
+                                             p2=P2.P2_LAST,
+                                             data=message):
+                yield i
+
+    @contextmanager
+    def sign_tx_multi_path(self, paths: List[str], transaction: bytes) -> Generator[None, None, None]:
+        messages = split_message(pack_derivation_path_list(paths) + transaction, MAX_APDU_LEN)
+
+        for i in range(0, len(messages) - 1):
+            self._backend.exchange(cla=CLA,
+                                   ins=InsType.INS_SIGN,
+                                   p1=P1.P1_START if i == 0 else P2.P2_MORE,
+                                   p2=P2.P2_SIGN_MULTI_PATH,
+                                   data=messages[i])
+
+        with self._backend.exchange_async(cla=CLA,
+                                          ins=InsType.INS_SIGN,
+                                          p1=P1.P1_START if len(messages) == 1 else P2.P2_MORE,
+                                          p2=P2.P2_SIGN_MULTI_PATH,
+                                          data=messages[-1]) as response:
+            yield response
+
+    @contextmanager
+    def sign_tx_delegation(self, path: str, origin: bytes, transaction: bytes) -> Generator[None, None, None]:
+        messages = split_message(pack_derivation_path(path) + origin + transaction, MAX_APDU_LEN)
+
+        for i in range(0, len(messages) - 1):
+            self._backend.exchange(cla=CLA,
+                                   ins=InsType.INS_SIGN,
+                                   p1=P1.P1_START if i == 0 else P2.P2_MORE,
+                                   p2=P2.P2_SIGN_DELEGATOR,
+                                   data=messages[i])
+
+        with self._backend.exchange_async(cla=CLA,
+                                          ins=InsType.INS_SIGN,
+                                          p1=P1.P1_START if len(messages) == 1 else P2.P2_MORE,
+                                          p2=P2.P2_SIGN_DELEGATOR,
+                                          data=messages[-1]) as response:
+            yield response
+
+    # The IDs returned for all the transactions but the last are kept in sequence_tx_ids
+    @contextmanager
+    def sign_tx_sequence(self, path: str, transactions: List[bytes]) -> Generator[None, None, None]:
+        self.sequence_tx_ids = []
+        for index, transaction in enumerate(transactions):
+            if index == 0:
+                messages = split_message(pack_derivation_path(path) + bytes([len(transactions)]) + transaction,
+                                         MAX_APDU_LEN)
+            else:
+                messages = split_message(transaction, MAX_APDU_LEN)
+            first_p1 = P1.P1_START if index == 0 else P1.P1_NEXT_TRANSACTION
+            if index == len(transactions) - 1:
+                break
+            for i, message in enumerate(messages):
+                rapdu = self._backend.exchange(cla=CLA,
+                                               ins=InsType.INS_SIGN,
+                                               p1=first_p1 if i == 0 else P2.P2_MORE,
+                                               p2=P2.P2_SIGN_SEQUENCE,
+                                               data=message)
+            self.sequence_tx_ids.append(rapdu.data)
+
+        for i in range(0, len(messages) - 1):
+            self._backend.exchange(cla=CLA,
+                                   ins=InsType.INS_SIGN,
+                                   p1=first_p1 if i == 0 else P2.P2_MORE,
+                                   p2=P2.P2_SIGN_SEQUENCE,
+                                   data=messages[i])
+
+        with self._backend.exchange_async(cla=CLA,
+                                          ins=InsType.INS_SIGN,
+                                          p1=first_p1 if len(messages) == 1 else P2.P2_MORE,
+                                          p2=P2.P2_SIGN_SEQUENCE,
+                                          data=messages[-1]) as response:
+            yield response
+
+    # Sends a single non-final chunk of a transaction to sign, see split_tx
+    def sign_tx_chunk(self, chunk: bytes, first: bool) -> RAPDU:
+        return self._backend.exchange(cla=CLA,
+                                      ins=InsType.INS_SIGN,
+                                      p1=P1.P1_START if first else P2.P2_MORE,
+                                      p2=P2.P2_LAST,
+                                      data=chunk)
+
+    def get_next_signatures(self, p2: int = P2.P2_SIGN_MULTI_PATH) -> RAPDU:
+        return self._backend.exchange(cla=CLA,
+                                      ins=InsType.INS_SIGN,
+                                      p1=P1.P1_NEXT_SIGNATURES,
+                                      p2=p2,
+                                      data=b"")
+
+    def get_last_response(self, signing_hash: bytes) -> RAPDU:
+        return self._backend.exchange(cla=CLA,
+                                      ins=InsType.INS_GET_LAST_RESPONSE,
+                                      p1=P1.P1_START,
+                                      p2=P2.P2_LAST,
+                                      data=signing_hash)
+
+    def get_stats(self, page: int = 0, reset: bool = False) -> RAPDU:
+        return self._backend.exchange(cla=CLA,
+                                      ins=InsType.INS_GET_STATS,
+                                      p1=page,
+                                      p2=0x01 if reset else 0x00,
+                                      data=b"")
+
+    # Only available in TRACE=1 builds
+    def get_trace(self, page: int = 0, clear: bool = False) -> RAPDU:
+        return self._backend.exchange(cla=CLA,
+                                      ins=InsType.INS_GET_TRACE,
+                                      p1=page,
+                                      p2=0x01 if clear else 0x00,
+                                      data=b"")
+
+    @contextmanager
+    def address_book_add(self, address: bytes, label: str) -> Generator[None, None, None]:
+        with self._backend.exchange_async(cla=CLA,
+                                         ins=InsType.INS_ADDRESS_BOOK,
+                                         p1=P1.P1_ADDRESS_BOOK_ADD,
+                                         p2=P2.P2_LAST,
+                                         data=address + label.encode()) as response:
+            yield response
+
+    @contextmanager
+    def address_book_remove(self, address: bytes) -> Generator[None, None, None]:
+        with self._backend.exchange_async(cla=CLA,
+                                         ins=InsType.INS_ADDRESS_BOOK,
+                                         p1=P1.P1_ADDRESS_BOOK_REMOVE,
+                                         p2=P2.P2_LAST,
+                                         data=address) as response:
+            yield response
+
+    # Requests refused before their review
+    def address_book(self, p1: int, data: bytes) -> RAPDU:
+        return self._backend.exchange(cla=CLA,
+                                      ins=InsType.INS_ADDRESS_BOOK,
+                                      p1=p1,
+                                      p2=P2.P2_LAST,
+                                      data=data)
+
+    # Only available in TOKEN_TEST_KEY=1 builds, or builds trusting a release key
+    def provide_token_info(self, descriptor: bytes) -> RAPDU:
+        return self._backend.exchange(cla=CLA,
+                                      ins=InsType.INS_PROVIDE_TOKEN_INFO,
+                                      p1=P1.P1_START,
+                                      p2=P2.P2_LAST,
+                                      data=descriptor)
+
     def get_async_response(self) -> Optional[RAPDU]:
         return self._backend.last_async_response
@@ -0,0 +1,183 @@
+# Generates tokens.c, the well known tokens of the application, from tokens.csv:
+#   python3 tokens/gen_tokens.py tokens/tokens.csv build/tokens/tokens.c
+#
+# Each line of the CSV is the address of a VIP-180 token contract, its ticker (1 to 10
+# printable characters, without space) and its decimals (at most 32).
+#
+# The tokens are indexed by a minimal perfect hash of their address (hash and displace):
+# the address is hashed into one of NUM_TOKEN_BUCKETS buckets, and the seed of its bucket
+# hashes it again into its slot of TOKENS, every slot holding exactly one token. A lookup
+# is two hashes and a single memcmp, whatever the number of tokens.
+#
+# Called by the Makefile on every build, the output file is only written when it changes.
+import csv
+import sys
+from pathlib import Path
+
+MAX_TICKER_LENGTH = 10
+MAX_TOKEN_DECIMALS = 32
+# Average number of tokens per bucket
+BUCKET_SIZE = 4
+MAX_SEED = 0xFFFF
+
+HEADER = """/*******************************************************************************
+*   Generated by tokens/gen_tokens.py from {source}, do not edit.
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#include <string.h>
+#include "tokens.h"
+"""
+
+LOOKUP = """
+#define NUM_TOKENS {count}
+#define NUM_TOKEN_BUCKETS {buckets}
+
+// Seed of each bucket, giving the slot of its tokens in TOKENS
+static const uint16_t TOKEN_SEEDS[NUM_TOKEN_BUCKETS] = {{
+{seeds}
+}};
+
+static const tokenDefinition_t TOKENS[NUM_TOKENS] = {{
+{tokens}
+}};
+
+// FNV-1a of the address from a seeded basis, then the murmur3 finalizer
+static uint32_t token_hash(const uint8_t *address, uint32_t seed) {{
+    uint32_t hash = 0x811C9DC5 ^ seed;
+    uint8_t i;
+
+    for (i = 0; i < 20; i++) {{
+        hash = (hash ^ address[i]) * 0x01000193;
+    }}
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6B;
+    hash ^= hash >> 13;
+    hash *= 0xC2B2AE35;
+    hash ^= hash >> 16;
+    return hash;
+}}
+
+const tokenDefinition_t *token_lookup(const uint8_t address[static 20]) {{
+    uint16_t seed = TOKEN_SEEDS[token_hash(address, 0) % NUM_TOKEN_BUCKETS];
+    const tokenDefinition_t *token = PIC(&TOKENS[token_hash(address, seed) % NUM_TOKENS]);
+
+    if (memcmp(token->address, address, 20) != 0) {{
+        return NULL;
+    }}
+    return token;
+}}
+"""
+
+NO_TOKEN = """
+const tokenDefinition_t *token_lookup(const uint8_t address[static 20]) {
+    UNUSED(address);
+    return NULL;
+}
+"""
+
+
+def token_hash(address: bytes, seed: int) -> int:
+    h = 0x811C9DC5 ^ seed
+    for byte in address:
+        h = ((h ^ byte) * 0x01000193) & 0xFFFFFFFF
+    h ^= h >> 16
+    h = (h * 0x85EBCA6B) & 0xFFFFFFFF
+    h ^= h >> 13
+    h = (h * 0xC2B2AE35) & 0xFFFFFFFF
+    h ^= h >> 16
+    return h
+
+
+def read_tokens(path: str) -> list:
+    tokens = []
+    addresses = set()
+    with open(path, newline="") as f:
+        for line, row in enumerate(csv.DictReader(f), start=2):
+            where = f"{path}:{line}"
+            address = row["address"].strip().lower()
+            if address.startswith("0x"):
+                address = address[2:]
+            if len(address) != 40:
+                sys.exit(f"{where}: invalid address")
+            address = bytes.fromhex(address)
+            if address in addresses:
+                sys.exit(f"{where}: duplicate address")
+            addresses.add(address)
+            ticker = row["ticker"].strip()
+            if not 1 <= len(ticker) <= MAX_TICKER_LENGTH or \
+                    any(not 0x20 < ord(c) < 0x7F for c in ticker):
+                sys.exit(f"{where}: invalid ticker")
+            decimals = int(row["decimals"])
+            if not 0 <= decimals <= MAX_TOKEN_DECIMALS:
+                sys.exit(f"{where}: invalid decimals")
+            tokens.append((address, ticker, decimals))
+    return tokens
+
+
+def perfect_hash(tokens: list) -> tuple:
+    count = len(tokens)
+    bucket_count = (count + BUCKET_SIZE - 1) // BUCKET_SIZE
+    buckets = [[] for _ in range(bucket_count)]
+    for token in tokens:
+        buckets[token_hash(token[0], 0) % bucket_count].append(token)
+
+    seeds = [0] * bucket_count
+    slots = [None] * count
+    # The largest buckets first, while most slots are free
+    for index in sorted(range(bucket_count), key=lambda b: -len(buckets[b])):
+        if not buckets[index]:
+            continue
+        for seed in range(1, MAX_SEED + 1):
+            positions = [token_hash(token[0], seed) % count for token in buckets[index]]
+            if len(set(positions)) == len(positions) and all(slots[p] is None for p in positions):
+                break
+        else:
+            sys.exit("no perfect hash found, try another BUCKET_SIZE")
+        seeds[index] = seed
+        for position, token in zip(positions, buckets[index]):
+            slots[position] = token
+    return seeds, slots
+
+
+def generate(source: str, tokens: list) -> str:
+    output = HEADER.format(source=source)
+    if not tokens:
+        return output + NO_TOKEN
+    seeds, slots = perfect_hash(tokens)
+    seed_lines = [", ".join(str(seed) for seed in seeds[i:i + 12]) for i in range(0, len(seeds), 12)]
+    token_lines = []
+    for address, ticker, decimals in slots:
+        token_lines.append("    {{{{{}}}, \"{} \", {}}}".format(
+            ", ".join(f"0x{byte:02x}" for byte in address),
+            ticker.replace("\\", "\\\\").replace("\"", "\\\""),
+            decimals))
+    return output + LOOKUP.format(count=len(tokens),
+                                  buckets=len(seeds),
+                                  seeds=",\n".join("    " + line for line in seed_lines),
+                                  tokens=",\n".join(token_lines))
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit(f"usage: {sys.argv[0]} tokens.csv tokens.c")
+    source, target = sys.argv[1], Path(sys.argv[2])
+    output = generate(source, read_tokens(source))
+    if not target.exists() or target.read_text() != output:
+        target.parent.mkdir(parents=True, exist_ok=True)
+        target.write_text(output)
+
+
+if __name__ == "__main__":
+    main()